@@ -0,0 +1,94 @@
+/* benchmark-lanes.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Benchmarks;
+using Gpseq;
+
+void benchmark_lanes () {
+	const int REQUESTS = 200;
+	int[] batches = { 0, 1, 2, 4, 8 };
+
+	WorkerPool pool;
+	try {
+		pool = new WorkerPool.with_defaults();
+	} catch (Error err) {
+		error(err.message);
+	}
+	WorkerPoolLane high = pool.create_lane("requests", TaskPriority.HIGH);
+	WorkerPoolLane low = pool.create_lane("batches", TaskPriority.LOW);
+	TaskEnv shared_env = new BenchmarkTaskEnv(pool);
+	TaskEnv batch_env = new BenchmarkTaskEnv(low);
+
+	benchmark(batches.length, r => {
+		int num_batches = batches[r.current_iteration];
+		r.set_xval( num_batches.to_string() );
+
+		r.report("shared-pool", s => {
+			run_mixed_workload(s, pool, shared_env, num_batches, REQUESTS);
+		});
+
+		r.report("priority-lanes", s => {
+			run_mixed_workload(s, high, batch_env, num_batches, REQUESTS);
+		});
+	}).print().save_data("lanes.dat");
+
+	pool.terminate_now();
+}
+
+/**
+ * Measures the total latency of short requests submitted one by one to
+ * //requests//, while //num_batches// threads keep running batch seqs in
+ * //batch_env//.
+ */
+private void run_mixed_workload (Stopwatch s, Executor requests, TaskEnv batch_env,
+		int num_batches, int num_requests) {
+	var array = create_rand_generic_int_array(5000000);
+	int stop = 0;
+	var threads = new Thread<void*>[num_batches];
+	for (int i = 0; i < num_batches; i++) {
+		threads[i] = new Thread<void*>("batch", () => {
+			while (AtomicInt.get(ref stop) == 0) {
+				Seq.of_generic_array<int>(array, batch_env)
+					.parallel()
+					.map<int>(g => (g ^ (g >> 7)) % 1000)
+					.fold<int>((g, a) => g + a, (a, b) => a + b, 0).value;
+			}
+			return null;
+		});
+	}
+	Thread.usleep(100000); // let the batches occupy the pool
+
+	s.start();
+	try {
+		for (int i = 0; i < num_requests; i++) {
+			var t = new FuncTask<int>(() => i * 2);
+			requests.submit(t);
+			t.future.wait();
+		}
+	} catch (Error err) {
+		error(err.message);
+	}
+	s.stop();
+
+	AtomicInt.set(ref stop, 1);
+	for (int i = 0; i < num_batches; i++) {
+		threads[i].join();
+	}
+}
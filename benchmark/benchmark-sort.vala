@@ -36,8 +36,11 @@ void benchmark_sort () {
 		r.report("GenericArray.sort_with_data", s => {
 			var array = create_rand_generic_int_array(length);
 			var cmp = Functions.get_compare_func_for(typeof(int));
+			reset_peak_rss();
 			s.start();
 			array.sort_with_data(cmp);
+			s.stop();
+			s.notate(peak_rss_note());
 		});
 
 		r.report("ArrayList.sort", s => {
@@ -45,14 +48,47 @@ void benchmark_sort () {
 			for (int i = 0; i < length; i++) {
 				list.add((int) Random.next_int());
 			}
+			reset_peak_rss();
 			s.start();
 			list.sort();
+			s.stop();
+			s.notate(peak_rss_note());
 		});
 
 		r.report("Gpseq.parallel_sort", s => {
 			var array = create_rand_generic_int_array(length);
+			reset_peak_rss();
 			s.start();
 			parallel_sort<int>(array.data).value;
+			s.stop();
+			s.notate(peak_rss_note());
+		});
+
+		r.report("Gpseq.parallel_sort_in_place", s => {
+			var array = create_rand_generic_int_array(length);
+			reset_peak_rss();
+			s.start();
+			parallel_sort_in_place<int>(array.data).value;
+			s.stop();
+			s.notate(peak_rss_note());
+		});
+
+		r.report("Gpseq.parallel_sort_by_key", s => {
+			var array = create_rand_generic_int_array(length);
+			reset_peak_rss();
+			s.start();
+			parallel_sort_by_key<int>(array.data, g => g).value;
+			s.stop();
+			s.notate(peak_rss_note());
+		});
+
+		r.report("Gpseq.parallel_sort_int64", s => {
+			int64[] array = create_rand_int64_array(length);
+			reset_peak_rss();
+			s.start();
+			parallel_sort_int64(array).value;
+			s.stop();
+			s.notate(peak_rss_note());
 		});
 	}).print().save_data("sort.dat");
 }
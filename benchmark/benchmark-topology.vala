@@ -0,0 +1,75 @@
+/* benchmark-topology.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Benchmarks;
+using Gpseq;
+
+void benchmark_topology () {
+	int[] nums = {
+		100000, 1000000, 5000000, 10000000, 20000000,
+		30000000, 40000000, 50000000
+	};
+
+	WorkerPool random_pool;
+	WorkerPool topology_pool;
+	try {
+		random_pool = new WorkerPool.with_defaults();
+		topology_pool = new WorkerPool.with_topology();
+	} catch (Error err) {
+		error(err.message);
+	}
+	TaskEnv random_env = new BenchmarkTaskEnv(random_pool);
+	TaskEnv topology_env = new BenchmarkTaskEnv(topology_pool);
+
+	benchmark(nums.length, r => {
+		int length = nums[r.current_iteration];
+		r.set_xval( length.to_string() );
+
+		r.report("random-stealing", s => {
+			var array = create_rand_generic_int_array(length);
+			s.start();
+			run_topology_workload(array, random_env);
+		});
+
+		r.report("topology-aware", s => {
+			var array = create_rand_generic_int_array(length);
+			s.start();
+			run_topology_workload(array, topology_env);
+		});
+	}).print().save_data("topology.dat");
+
+	random_pool.terminate_now();
+	topology_pool.terminate_now();
+}
+
+/**
+ * A steal-heavy workload: a filter-map-fold followed by a sort, which both
+ * split the input into many small tasks.
+ */
+private void run_topology_workload (GenericArray<int> array, TaskEnv env) {
+	Seq.of_generic_array<int>(array, env)
+		.parallel()
+		.filter(g => g % 4 == 0)
+		.map<int>(g => g * 726)
+		.fold<int>((g, a) => g + a, (a, b) => a + b, 0).value;
+	TaskEnv.apply(env, () => {
+		parallel_sort<int>(array.data).value;
+	});
+}
@@ -27,4 +27,6 @@ void main () {
 	print("Executor parallelism: %u\n", parallels);
 	benchmark_sort();
 	benchmark_fmf();
+	benchmark_topology();
+	benchmark_lanes();
 }
@@ -11,12 +11,15 @@ set grid
 set style line 1 linecolor rgb 'red' linetype 1 linewidth 1.5 pointtype 6 pointsize 1
 set style line 2 linecolor rgb 'green' linetype 1 linewidth 1.5 pointtype 6 pointsize 1
 set style line 3 linecolor rgb 'blue' linetype 1 linewidth 1.5 pointtype 6 pointsize 1
+set style line 4 linecolor rgb 'orange' linetype 1 linewidth 1.5 pointtype 6 pointsize 1
+set style line 5 linecolor rgb 'purple' linetype 1 linewidth 1.5 pointtype 6 pointsize 1
+set style line 6 linecolor rgb 'brown' linetype 1 linewidth 1.5 pointtype 6 pointsize 1
 
 set terminal png size 1280,960
 set output 'sort.png'
 
-plot for [i=2:4] 'sort.dat' using 1:i with linespoints linestyle i-1, \
-	for [i=2:4] '' using 1:i:(sprintf('%.2fs', column(i))) with labels offset 2.5,0.5 notitle
+plot for [i=2:7] 'sort.dat' using 1:i with linespoints linestyle i-1, \
+	for [i=2:7] '' using 1:i:(sprintf('%.2fs', column(i))) with labels offset 2.5,0.5 notitle
 
 set terminal wxt persist
 
@@ -18,6 +18,8 @@
  * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+using Gpseq;
+
 public GenericArray<int> create_rand_generic_int_array (int len) {
 	var array = new GenericArray<int>(len);
 	for (int i = 0; i < len; i++) {
@@ -25,3 +27,70 @@ public GenericArray<int> create_rand_generic_int_array (int len) {
 	}
 	return array;
 }
+
+public int64[] create_rand_int64_array (int len) {
+	int64[] array = new int64[len];
+	for (int i = 0; i < len; i++) {
+		array[i] = (int64) Random.next_int() << 32 | Random.next_int();
+	}
+	return array;
+}
+
+/**
+ * Resets the peak resident set size of this process. Linux only.
+ */
+public void reset_peak_rss () {
+	try {
+		FileUtils.set_contents("/proc/self/clear_refs", "5");
+	} catch (FileError err) {
+		// not supported
+	}
+}
+
+/**
+ * Gets a note of the peak resident set size of this process since the last
+ * reset_peak_rss() call. Linux only.
+ */
+public string peak_rss_note () {
+	string contents;
+	try {
+		FileUtils.get_contents("/proc/self/status", out contents);
+	} catch (FileError err) {
+		return "";
+	}
+	foreach (unowned string line in contents.split("\n")) {
+		if (line.has_prefix("VmHWM:")) {
+			int64 kib = int64.parse(line.substring(6).strip());
+			return "peak %s".printf(format_size((uint64) kib * 1024));
+		}
+	}
+	return "";
+}
+
+/**
+ * A task env with the given executor, which resolves thresholds and max
+ * depths by the default task env.
+ */
+public class BenchmarkTaskEnv : TaskEnv {
+	private Executor _executor;
+	private TaskEnv _default_env;
+
+	public BenchmarkTaskEnv (Executor executor) {
+		_executor = executor;
+		_default_env = TaskEnv.get_default_task_env();
+	}
+
+	public override Executor executor {
+		get {
+			return _executor;
+		}
+	}
+
+	public override int64 resolve_threshold (int64 elements, int threads) {
+		return _default_env.resolve_threshold(elements, threads);
+	}
+
+	public override int resolve_max_depth (int64 elements, int threads) {
+		return _default_env.resolve_max_depth(elements, threads);
+	}
+}
@@ -0,0 +1,166 @@
+/* AdaptiveTaskEnv.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A task environment that adjusts the split granularity of fork-join
+	 * tasks from runtime measurements.
+	 *
+	 * The leaf tasks run by this environment are timed, and the average
+	 * computation time per element is estimated from them. The threshold is
+	 * then chosen so that a leaf takes about {@link target_leaf_time}: cheap
+	 * elements are processed in large leaves, and expensive elements are
+	 * split finely. A workload that is estimated to take less than one leaf
+	 * is not split at all.
+	 *
+	 * The estimate is a decaying average over all the seqs executed with
+	 * this environment, so seqs with different per-element costs should use
+	 * separate environments.
+	 *
+	 * Until the first leaf has been measured, the thresholds of the default
+	 * task environment at the time of construction are used.
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class AdaptiveTaskEnv : TaskEnv {
+		private const double DECAY = 0.9;
+		private const double MIN_ELEMENT_COST = 0.001; // 1 ns
+		private const int MAX_LEAVES_PER_THREAD = 64;
+
+		private TaskEnv _fallback;
+		private Executor _executor;
+		private int64 _target_leaf_time;
+		private double _elements;
+		private double _elapsed;
+
+		/**
+		 * Creates a new adaptive task environment.
+		 *
+		 * @param executor the executor that runs tasks. if not specified, the
+		 * executor of the default task environment is used
+		 * @param target_leaf_time the desired computation time of a leaf task
+		 * in microseconds
+		 */
+		public AdaptiveTaskEnv (Executor? executor = null, int64 target_leaf_time = 250)
+			requires (target_leaf_time > 0)
+		{
+			_fallback = TaskEnv.get_default_task_env();
+			_executor = new ObservedExecutor(executor ?? _fallback.executor, this);
+			_target_leaf_time = target_leaf_time;
+		}
+
+		public override Executor executor {
+			get {
+				return _executor;
+			}
+		}
+
+		/**
+		 * The desired computation time of a leaf task in microseconds.
+		 */
+		public int64 target_leaf_time {
+			get {
+				return _target_leaf_time;
+			}
+		}
+
+		/**
+		 * The estimated computation time per element in microseconds, or a
+		 * negative value if nothing has been measured.
+		 */
+		public double element_cost {
+			get {
+				lock (_elements) {
+					return _elements > 0 ? double.max(_elapsed / _elements, MIN_ELEMENT_COST) : -1;
+				}
+			}
+		}
+
+		/**
+		 * Discards the measurements.
+		 */
+		public void reset () {
+			lock (_elements) {
+				_elements = 0;
+				_elapsed = 0;
+			}
+		}
+
+		private void record (int64 elements, int64 elapsed) {
+			if (elements <= 0) return;
+			lock (_elements) {
+				_elements = _elements * DECAY + elements;
+				_elapsed = _elapsed * DECAY + elapsed;
+			}
+		}
+
+		public override int64 resolve_threshold (int64 elements, int threads) {
+			double cost = element_cost;
+			if (threads == 1 || cost < 0) {
+				return _fallback.resolve_threshold(elements, threads);
+			}
+
+			double grain_d = _target_leaf_time / cost;
+			int64 grain = grain_d >= int64.MAX ? int64.MAX : int64.max((int64) grain_d, 1);
+			if (elements < 0) return grain;
+			if (elements <= grain) return int64.max(elements, 1);
+
+			// at least two leaves per thread, and not too many
+			int64 upper = int64.max(elements / ((int64) threads * 2), 1);
+			int64 lower = int64.max(elements / ((int64) threads * MAX_LEAVES_PER_THREAD), 1);
+			return int64.min(int64.max(grain, lower), upper);
+		}
+
+		public override int resolve_max_depth (int64 elements, int threads) {
+			if (threads == 1 || elements < 0 || element_cost < 0) {
+				return _fallback.resolve_max_depth(elements, threads);
+			}
+			return -1; // limited by the threshold
+		}
+
+		/**
+		 * An executor which delegates tasks to another executor, and records
+		 * the leaf computation times to the task environment.
+		 */
+		private class ObservedExecutor : Object, Executor, LeafObserver {
+			private Executor _executor;
+			private weak AdaptiveTaskEnv _env;
+
+			public ObservedExecutor (Executor executor, AdaptiveTaskEnv env) {
+				_executor = executor;
+				_env = env;
+			}
+
+			public void submit (Task task) {
+				_executor.submit(task);
+			}
+
+			public int parallels {
+				get {
+					return _executor.parallels;
+				}
+			}
+
+			public void leaf_computed (int64 elements, int64 elapsed) {
+				AdaptiveTaskEnv? env = _env;
+				if (env != null) env.record(elements, elapsed);
+			}
+		}
+	}
+}
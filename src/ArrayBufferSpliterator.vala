@@ -70,5 +70,13 @@ namespace Gpseq {
 				return true;
 			}
 		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return SpliteratorCharacteristics.ORDERED
+					| SpliteratorCharacteristics.SIZED
+					| SpliteratorCharacteristics.SUBSIZED;
+			}
+		}
 	}
 }
@@ -0,0 +1,71 @@
+/* CancelGuard.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A cancellation token and a deadline, shared by a seq pipeline and all the
+	 * partitions of its source.
+	 *
+	 * The fields are set while the pipeline is being built, and are only read
+	 * after it has been started.
+	 */
+	internal class CancelGuard : Object {
+		private CancellationToken? _token;
+		private int64 _deadline = int64.MAX;
+
+		public CancellationToken? token {
+			get {
+				return _token;
+			}
+			set {
+				_token = value;
+			}
+		}
+
+		/**
+		 * The monotonic time, in microseconds, after which the pipeline is
+		 * interrupted. int64.MAX if there is no deadline.
+		 */
+		public int64 deadline {
+			get {
+				return _deadline;
+			}
+			set {
+				_deadline = value;
+			}
+		}
+
+		/**
+		 * Throws an error if the token has been cancelled or the deadline has
+		 * passed.
+		 *
+		 * @throws CancellationError.CANCELLED if the token has been cancelled
+		 * @throws CancellationError.TIMED_OUT if the deadline has passed
+		 */
+		public void check () throws CancellationError {
+			if (_token != null) {
+				_token.check();
+			}
+			if (_deadline != int64.MAX && get_monotonic_time() >= _deadline) {
+				throw new CancellationError.TIMED_OUT("The deadline has passed");
+			}
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/* CancellationToken.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A thread-safe token used to interrupt running seq operations.
+	 *
+	 * @see Seq.with_cancellation
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class CancellationToken : Object {
+		private AtomicBoolVal _cancelled;
+
+		/**
+		 * Creates a new token which has not been cancelled.
+		 */
+		public CancellationToken () {
+			_cancelled = new AtomicBoolVal();
+		}
+
+		/**
+		 * Whether or not this token has been cancelled.
+		 */
+		public bool is_cancelled {
+			get {
+				return _cancelled.val;
+			}
+		}
+
+		/**
+		 * Cancels this token. If this token has already been cancelled, this
+		 * method does nothing.
+		 */
+		public void cancel () {
+			_cancelled.val = true;
+		}
+
+		/**
+		 * Throws an error if this token has been cancelled.
+		 *
+		 * @throws CancellationError.CANCELLED if this token has been cancelled
+		 */
+		public void check () throws CancellationError {
+			if (_cancelled.val) {
+				throw new CancellationError.CANCELLED("The operation has been cancelled");
+			}
+		}
+	}
+}
@@ -0,0 +1,215 @@
+/* CoGroupContainer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+namespace Gpseq {
+	/**
+	 * A container which contains the results of co-grouping a input with
+	 * another seq.
+	 *
+	 * Both are collected into {@link JoinTable}s with the same partitions
+	 * when the container is started, and then the groups of each partition
+	 * are combined by one task, so the results are produced in parallel and
+	 * stored in an array.
+	 */
+	internal class CoGroupContainer<R,G,K,H> : Object, Spliterator<R>, Container<R,G> {
+		private Spliterator<G>? _spliterator; // may be a Container
+		private Container<G,void*>? _parent;
+		private Seq<H>? _other;
+		private MapFunc<K,G>? _key;
+		private MapFunc<K,H>? _other_key;
+		private CoGroupFunc<R,K,G,H>? _combiner;
+		private JoinTable<K,G>? _left;
+		private JoinTable<K,H>? _right;
+		private Spliterator<R>? _output; // available after started
+
+		/**
+		 * Creates a new co-group container.
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new container
+		 * @param other the other seq
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * the input
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @param combiner a //non-interfering// and //stateless// function
+		 * combining the groups of a key
+		 */
+		public CoGroupContainer (Spliterator<G> spliterator, Container<G,void*>? parent,
+				Seq<H> other, owned MapFunc<K,G> key, owned MapFunc<K,H> other_key,
+				owned CoGroupFunc<R,K,G,H> combiner) {
+			_spliterator = spliterator;
+			_parent = parent;
+			_other = other;
+			_key = (owned) key;
+			_other_key = (owned) other_key;
+			_combiner = (owned) combiner;
+		}
+
+		public Container<G,void*>? parent {
+			get {
+				return _parent;
+			}
+		}
+
+		public Future<void*> start (Seq seq) {
+			var future = _parent != null ? _parent.start(seq) : Future.of<void*>(null);
+			_parent = null;
+			return (Future<void*>) future.flat_map<void*>(value => {
+				return build(seq);
+			});
+		}
+
+		/**
+		 * Collects the input and the other seq into the tables. Both are
+		 * collected in parallel if the given seq is parallel.
+		 */
+		private Future<void*> build (Seq seq) {
+			Seq<G> input = new Seq<G>((!) _spliterator, seq.task_env);
+			Seq<H> other = (owned) _other;
+			_spliterator = null;
+			if (seq.is_parallel) {
+				input = input.parallel();
+				if (!other.is_parallel) other = other.parallel();
+			}
+			int partitions = input.is_parallel || other.is_parallel
+					? JoinTable.resolve_partitions(seq.task_env.executor.parallels)
+					: 1;
+			var left = new Collectors.JoinTableCollector<K,G>(
+					(owned) _key, partitions, input.task_env.executor);
+			var right = new Collectors.JoinTableCollector<K,H>(
+					(owned) _other_key, partitions, other.task_env.executor);
+			return (Future<void*>) input.collect<JoinTable<K,G>,Object>(left).flat_map<void*>(table => {
+				_left = table;
+				return other.collect<JoinTable<K,H>,Object>(right).flat_map<void*>(other_table => {
+					_right = other_table;
+					return combine(seq);
+				});
+			});
+		}
+
+		private Future<void*> combine (Seq seq) {
+			int partitions = _left.num_partitions;
+			if (seq.is_parallel && partitions > 1) {
+				var task = new CoGroupTask<R,G,K,H>(this, 0, partitions, null, seq.task_env.executor);
+				task.fork();
+				return (Future<void*>) task.future.map<void*>(value => {
+					set_output(value);
+					return null;
+				});
+			} else {
+				try {
+					set_output(combine_range(0, partitions));
+					return Future.of<void*>(null);
+				} catch (Error err) {
+					var promise = new Promise<void*>();
+					promise.set_exception((owned) err);
+					return promise.future;
+				}
+			}
+		}
+
+		private void set_output (ArrayBuffer<R> results) {
+			_output = new ArrayBufferSpliterator<R>(results, 0, results.size);
+			_left = null;
+			_right = null;
+			_combiner = null;
+		}
+
+		/**
+		 * Combines the groups of the partitions in the given range: first the
+		 * keys of the input in encounter order, and then the keys only in the
+		 * other seq in encounter order.
+		 *
+		 * @param start the first partition
+		 * @param end the partition after the last one
+		 * @return the results
+		 */
+		internal ArrayBuffer<R> combine_range (int start, int end) throws Error {
+			int size = 0;
+			for (int i = start; i < end; i++) {
+				size += _left.get_partition(i).num_heads + _right.get_partition(i).num_heads;
+			}
+			R[] results = new R[size];
+			int idx = 0;
+			for (int i = start; i < end; i++) {
+				unowned JoinTable.Partition<K,G> lp = _left.get_partition(i);
+				unowned JoinTable.Partition<K,H> rp = _right.get_partition(i);
+				for (int j = 0; j < lp.num_heads; j++) {
+					int e = lp.heads[j];
+					int r = _right.find_in(i, lp.keys[e], lp.hashes[e]);
+					results[idx++] = _combiner(lp.keys[e], group_of<G>(lp, e), group_of<H>(rp, r));
+				}
+				for (int j = 0; j < rp.num_heads; j++) {
+					int e = rp.heads[j];
+					if (_left.find_in(i, rp.keys[e], rp.hashes[e]) >= 0) continue;
+					results[idx++] = _combiner(rp.keys[e], group_of<G>(lp, -1), group_of<H>(rp, e));
+				}
+			}
+			if (results.length != idx) results.resize(idx);
+			return new ArrayBuffer<R>((owned) results);
+		}
+
+		private Gee.List<T> group_of<T> (JoinTable.Partition<K,T> p, int e) {
+			var list = new ArrayList<T>();
+			for (; e >= 0; e = p.next_same[e]) {
+				list.add(p.values[e]);
+			}
+			return list;
+		}
+
+		public Spliterator<R>? try_split () {
+			return _output != null ? _output.try_split() : null;
+		}
+
+		public bool try_advance (Func<R> consumer) throws Error {
+			return _output.try_advance(consumer);
+		}
+
+		public int64 estimated_size {
+			get {
+				return _output != null ? _output.estimated_size : -1;
+			}
+		}
+
+		public bool is_size_known {
+			get {
+				return _output != null;
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				// the order of the groups depends on the partitioning
+				if (_output == null) return 0;
+				return _output.characteristics & ~SpliteratorCharacteristics.ORDERED;
+			}
+		}
+
+		public void each (Func<R> f) throws Error {
+			_output.each(f);
+		}
+
+		public bool each_chunk (EachChunkFunc<R> f) throws Error {
+			return _output.each_chunk(f);
+		}
+	}
+}
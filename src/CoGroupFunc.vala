@@ -0,0 +1,30 @@
+/* CoGroupFunc.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * Combines the elements of two seqs that have the same key and returns
+	 * the result.
+	 *
+	 * At least one of the lists is non-empty.
+	 */
+	[Version (since="0.4.0-alpha")]
+	public delegate R CoGroupFunc<R,K,G,H> (K key, Gee.List<G> left, Gee.List<H> right) throws Error;
+}
@@ -0,0 +1,65 @@
+/* CoGroupTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A task that combines the groups of a range of partitions, one
+	 * partition per leaf, for {@link CoGroupContainer}.
+	 */
+	internal class CoGroupTask<R,G,K,H> : RangeTask<ArrayBuffer<R>> {
+		private CoGroupContainer<R,G,K,H> _container;
+
+		/**
+		 * Creates a new co-group task.
+		 *
+		 * @param container the container whose tables are combined
+		 * @param start the first partition
+		 * @param end the partition after the last one
+		 * @param parent the parent of this task
+		 * @param executor an executor that will invoke the task
+		 */
+		public CoGroupTask (CoGroupContainer<R,G,K,H> container, int start, int end,
+				CoGroupTask<R,G,K,H>? parent, Executor executor)
+		{
+			base(start, end, parent, 1, -1, executor);
+			_container = container;
+		}
+
+		protected override ArrayBuffer<R> leaf_compute (int start, int end) throws Error {
+			return _container.combine_range(start, end);
+		}
+
+		protected override ArrayBuffer<R> merge_results (owned ArrayBuffer<R> left, owned ArrayBuffer<R> right) {
+			if (left.size == 0) {
+				return right;
+			} else if (right.size == 0) {
+				return left;
+			} else {
+				return new ConcatArrayBuffer<R>(left, right);
+			}
+		}
+
+		protected override RangeTask<ArrayBuffer<R>> make_child (int start, int end) {
+			var task = new CoGroupTask<R,G,K,H>(_container, start, end, this, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
@@ -53,8 +53,11 @@ namespace Gpseq {
 
 		protected override A leaf_compute () throws Error {
 			A result = _collector.create_accumulator();
-			spliterator.each(g => {
-				_collector.accumulate(g, result);
+			spliterator.each_chunk(chunk => {
+				for (int i = 0; i < chunk.length; i++) {
+					_collector.accumulate(chunk[i], result);
+				}
+				return true;
 			});
 			return result;
 		}
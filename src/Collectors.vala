@@ -355,6 +355,66 @@ namespace Gpseq {
 			return new GroupByCollector<K,V,G>((owned) classifier, downstream);
 		}
 
+		/**
+		 * Returns a collector that groups the elements based on the
+		 * //classifier// function, like {@link group_by}, but partitions the
+		 * keys into shards to merge the groups of parallel leaves in
+		 * parallel.
+		 *
+		 * Each leaf hash-partitions its groups into shards, and the i-th
+		 * shards of all the leaves are merged by one task, so each key is
+		 * merged once rather than once per level of the task tree. This suits
+		 * groupings with many distinct keys.
+		 *
+		 * There are no guarantees on the type, mutability, or thread-safety of
+		 * the returned map and list.
+		 *
+		 * @param classifier a classifier function mapping elements to keys
+		 * @param cardinality an estimate of the number of distinct keys, used
+		 * to choose the number of shards, or a negative value if unknown
+		 * @param env the task environment of the seq to be collected, whose
+		 * executor merges the shards. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the collector implementation
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Collector<Map<K,Gee.List<G>>,Object,G> sharded_group_by<K,G> (
+				owned MapFunc<K,G> classifier, int64 cardinality = -1, TaskEnv? env = null) {
+			return sharded_group_by_with<K,Gee.List<G>,G>((owned) classifier, to_list<G>(), cardinality, env);
+		}
+
+		/**
+		 * Returns a collector that groups the elements based on the
+		 * //classifier// function, and performs a reduction operation on the
+		 * values of each key using the //downstream// collector, like
+		 * {@link group_by_with}, but partitions the keys into shards to merge
+		 * the groups of parallel leaves in parallel.
+		 *
+		 * The downstream accumulators of each shard are combined and finished
+		 * by the task that merges the shard.
+		 *
+		 * There are no guarantees on the type, mutability, or thread-safety of
+		 * the returned map.
+		 *
+		 * @param classifier a classifier function mapping elements to keys
+		 * @param downstream a downstream collector
+		 * @param cardinality an estimate of the number of distinct keys, used
+		 * to choose the number of shards, or a negative value if unknown
+		 * @param env the task environment of the seq to be collected, whose
+		 * executor merges the shards. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the collector implementation
+		 * @see sharded_group_by
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Collector<Map<K,V>,Object,G> sharded_group_by_with<K,V,G> (
+				owned MapFunc<K,G> classifier, Collector<V,Object,G> downstream,
+				int64 cardinality = -1, TaskEnv? env = null) {
+			TaskEnv task_env = env ?? TaskEnv.get_common_task_env();
+			return new ShardedGroupByCollector<K,V,G>((owned) classifier, downstream,
+					cardinality, task_env.executor);
+		}
+
 		/* TODO
 		public Collector<Map<K,Gee.List<G>>,Object,G> concurrent_group_by<K,G> (
 				owned MapFunc<K,G> classifier)
@@ -434,6 +494,29 @@ namespace Gpseq {
 			return reduce((a, b) => { return compare(a, b) <= 0 ? a : b; });
 		}
 
+		/**
+		 * Returns a collector that produces a list of the //k// least
+		 * elements, sorted based on the given compare function. Equal
+		 * elements are kept in encounter order.
+		 *
+		 * Each accumulator keeps only a bounded heap of //k// elements.
+		 *
+		 * @param k maximum number of elements the list may contain
+		 * @param compare a compare function. if not specified,
+		 * {@link Gee.Functions.get_compare_func_for} is used to get a proper
+		 * function.
+		 * @return the collector implementation
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Collector<Gee.List<G>,Object,G> top_k<G> (int64 k, owned CompareDataFunc<G>? compare = null)
+			requires (k >= 0)
+		{
+			if (compare == null) {
+				compare = Functions.get_compare_func_for(typeof(G));
+			}
+			return (Collector<Gee.List<G>,Object,G>) new TopKCollector<G>(k, (owned) compare);
+		}
+
 		/**
 		 * Returns a collector that counts the number of elements.
 		 *
@@ -0,0 +1,153 @@
+/* ConcurrentHashSet.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A hash set that supports concurrent insertions.
+	 *
+	 * The set is divided into segments, each of which is an open addressing
+	 * table guarded by its own lock. An element is assigned to a segment by
+	 * the high bits of its hash, so threads adding different elements rarely
+	 * contend for the same lock.
+	 */
+	internal class ConcurrentHashSet<G> {
+		private const int MAX_SEGMENTS = 1 << 12;
+		private const int INITIAL_CAPACITY = 16; // must be a power of two
+		private const uint GOLDEN_RATIO = 0x9E3779B9U;
+
+		private HashDataFunc<G> _hash;
+		private EqualDataFunc<G> _equal;
+		private Segment<G>[] _segments;
+		private int _shift;
+
+		/**
+		 * Creates a new concurrent hash set.
+		 *
+		 * @param hash a //non-interfering// and //stateless// hash function
+		 * @param equal a //non-interfering// and //stateless// equal function
+		 * @param concurrency the estimated number of threads that will add
+		 * elements concurrently
+		 */
+		public ConcurrentHashSet (owned HashDataFunc<G> hash, owned EqualDataFunc<G> equal, int concurrency) {
+			_hash = (owned) hash;
+			_equal = (owned) equal;
+			int bits = 0;
+			int64 want = int64.max(1, (int64)concurrency * 4);
+			while ((1 << bits) < want && (1 << bits) < MAX_SEGMENTS) bits++;
+			_shift = 32 - bits;
+			_segments = new Segment<G>[1 << bits];
+			for (int i = 0; i < _segments.length; i++) {
+				_segments[i] = new Segment<G>(INITIAL_CAPACITY);
+			}
+		}
+
+		/**
+		 * Adds the given element to this set if it is not already present.
+		 *
+		 * @param item an element
+		 * @return true if the element has been added, or false if an equal
+		 * element has already been present
+		 */
+		public bool add (G item) {
+			uint h = spread(_hash(item));
+			unowned Segment<G> seg = _segments[_shift == 32 ? 0 : (h >> _shift)];
+			seg.mutex.lock();
+			bool added = seg.add(item, h, _equal);
+			seg.mutex.unlock();
+			return added;
+		}
+
+		/**
+		 * The number of elements.
+		 *
+		 * The result is exact only when no element is being added.
+		 */
+		public int64 size {
+			get {
+				int64 result = 0;
+				for (int i = 0; i < _segments.length; i++) {
+					_segments[i].mutex.lock();
+					result += _segments[i].size;
+					_segments[i].mutex.unlock();
+				}
+				return result;
+			}
+		}
+
+		private static inline uint spread (uint h) {
+			return h * GOLDEN_RATIO;
+		}
+
+		private class Segment<G> {
+			public Mutex mutex;
+			public int size;
+			private G[] _items;
+			private uint[] _hashes;
+			private bool[] _used;
+
+			public Segment (int capacity) {
+				mutex = Mutex();
+				_items = new G[capacity];
+				_hashes = new uint[capacity];
+				_used = new bool[capacity];
+			}
+
+			public bool add (G item, uint h, EqualDataFunc<G> equal) {
+				int mask = _items.length - 1;
+				int i = (int)(h & mask);
+				while (_used[i]) {
+					if (_hashes[i] == h && equal(_items[i], item)) {
+						return false;
+					}
+					i = (i + 1) & mask;
+				}
+				_items[i] = item;
+				_hashes[i] = h;
+				_used[i] = true;
+				if (++size > (_items.length >> 1) + (_items.length >> 2)) {
+					grow();
+				}
+				return true;
+			}
+
+			private void grow () {
+				int capacity = _items.length << 1;
+				if (capacity <= 0) {
+					error("ConcurrentHashSet exceeds max segment capacity");
+				}
+				G[] items = new G[capacity];
+				uint[] hashes = new uint[capacity];
+				bool[] used = new bool[capacity];
+				int mask = capacity - 1;
+				for (int j = 0; j < _items.length; j++) {
+					if (!_used[j]) continue;
+					int i = (int)(_hashes[j] & mask);
+					while (used[i]) i = (i + 1) & mask;
+					items[i] = (owned) _items[j];
+					hashes[i] = _hashes[j];
+					used[i] = true;
+				}
+				_items = (owned) items;
+				_hashes = (owned) hashes;
+				_used = (owned) used;
+			}
+		}
+	}
+}
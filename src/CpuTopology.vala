@@ -0,0 +1,230 @@
+/* CpuTopology.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * The topology of the logical CPUs of the machine.
+	 *
+	 * On Linux, the topology is read from /sys/devices/system/cpu.
+	 * Otherwise, or if it can't be read, all CPUs are considered to be
+	 * independent cores on a single node.
+	 */
+	internal class CpuTopology : Object {
+		private const string SYSFS_CPU = "/sys/devices/system/cpu";
+
+		/**
+		 * The distance between a CPU and itself.
+		 */
+		public const int SAME_CPU = 0;
+		/**
+		 * The distance between CPUs that share a core or an L2 cache.
+		 */
+		public const int SIBLING = 1;
+		/**
+		 * The distance between CPUs on the same NUMA node.
+		 */
+		public const int SAME_NODE = 2;
+		/**
+		 * The distance between CPUs on different NUMA nodes.
+		 */
+		public const int REMOTE = 3;
+
+		private static CpuTopology? instance;
+
+		/**
+		 * Gets the topology of this machine. The topology is read when this
+		 * method is called initially.
+		 *
+		 * @return the topology of this machine
+		 */
+		public static CpuTopology get_default () {
+			lock (instance) {
+				if (instance == null) {
+					instance = new CpuTopology.detect();
+				}
+				return (!)instance;
+			}
+		}
+
+		private int[] _cpus; // ordered by locality
+		private int[] _nodes; // indexed by cpu id
+		private int[] _groups; // indexed by cpu id; shared L2 or core
+
+		/**
+		 * Reads the topology of this machine.
+		 */
+		public CpuTopology.detect () {
+			int[] cpus = parse_cpu_list( read_file(SYSFS_CPU + "/online") );
+			if (cpus.length == 0) {
+				int n = (int) GLib.get_num_processors();
+				cpus = new int[n];
+				for (int i = 0; i < n; i++) cpus[i] = i;
+			}
+
+			int max_cpu = 0;
+			foreach (int cpu in cpus) max_cpu = int.max(max_cpu, cpu);
+			_nodes = new int[max_cpu + 1];
+			_groups = new int[max_cpu + 1];
+			int[] packages = new int[max_cpu + 1];
+			for (int i = 0; i <= max_cpu; i++) {
+				_groups[i] = i;
+			}
+
+			foreach (int cpu in cpus) {
+				string dir = "%s/cpu%d".printf(SYSFS_CPU, cpu);
+				packages[cpu] = read_int(dir + "/topology/physical_package_id", 0);
+				_nodes[cpu] = read_node(dir, packages[cpu]);
+				int[] shared = parse_cpu_list( read_file(dir + "/cache/index2/shared_cpu_list") );
+				if (shared.length == 0) {
+					shared = parse_cpu_list( read_file(dir + "/topology/thread_siblings_list") );
+				}
+				foreach (int sibling in shared) {
+					_groups[cpu] = int.min(_groups[cpu], sibling);
+				}
+			}
+
+			// sort by (node, package, group, cpu); insertion sort is enough for
+			// the number of CPUs
+			for (int i = 1; i < cpus.length; i++) {
+				int cpu = cpus[i];
+				int j = i - 1;
+				while (j >= 0 && compare_location(cpus[j], cpu, packages) > 0) {
+					cpus[j + 1] = cpus[j];
+					j--;
+				}
+				cpus[j + 1] = cpu;
+			}
+			_cpus = cpus;
+		}
+
+		/**
+		 * The number of the online logical CPUs.
+		 */
+		public int num_cpus {
+			get {
+				return _cpus.length;
+			}
+		}
+
+		/**
+		 * Gets the CPU id at the given index. CPUs close to each other have
+		 * close indices.
+		 *
+		 * @param index an index. it is wrapped around if >= num_cpus
+		 * @return the CPU id
+		 */
+		public int cpu_at (int index)
+			requires (index >= 0)
+		{
+			return _cpus[index % _cpus.length];
+		}
+
+		/**
+		 * Calculates the distance between the given CPUs.
+		 *
+		 * @return one of {@link SAME_CPU}, {@link SIBLING}, {@link SAME_NODE},
+		 * and {@link REMOTE}
+		 */
+		public int distance (int a, int b) {
+			if (a == b) return SAME_CPU;
+			if (a < 0 || b < 0 || a >= _nodes.length || b >= _nodes.length) return REMOTE;
+			if (_groups[a] == _groups[b]) return SIBLING;
+			if (_nodes[a] == _nodes[b]) return SAME_NODE;
+			return REMOTE;
+		}
+
+		private int compare_location (int a, int b, int[] packages) {
+			if (_nodes[a] != _nodes[b]) return _nodes[a] < _nodes[b] ? -1 : 1;
+			if (packages[a] != packages[b]) return packages[a] < packages[b] ? -1 : 1;
+			if (_groups[a] != _groups[b]) return _groups[a] < _groups[b] ? -1 : 1;
+			return a < b ? -1 : (a == b ? 0 : 1);
+		}
+
+		private static int read_node (string cpu_dir, int fallback) {
+			try {
+				Dir dir = Dir.open(cpu_dir);
+				unowned string? name;
+				while ((name = dir.read_name()) != null) {
+					if (name.has_prefix("node")) {
+						int node;
+						if (parse_int(name.substring(4), out node)) return node;
+					}
+				}
+			} catch (FileError err) {
+				// not supported; fall through
+			}
+			return fallback;
+		}
+
+		private static int read_int (string path, int fallback) {
+			string? text = read_file(path);
+			int result;
+			if (text != null && parse_int(text.strip(), out result)) {
+				return result;
+			}
+			return fallback;
+		}
+
+		private static string? read_file (string path) {
+			string text;
+			try {
+				if (FileUtils.get_contents(path, out text)) return text;
+			} catch (FileError err) {
+				// not supported; fall through
+			}
+			return null;
+		}
+
+		/**
+		 * Parses a non-negative decimal integer.
+		 */
+		private static bool parse_int (string text, out int result) {
+			result = 0;
+			if (text.length == 0) return false;
+			for (int i = 0; i < text.length; i++) {
+				char c = text[i];
+				if (!c.isdigit() || result > (int.MAX - 9) / 10) return false;
+				result = result * 10 + (c - '0');
+			}
+			return true;
+		}
+
+		/**
+		 * Parses a CPU list, e.g. "0-3,8,10-11".
+		 */
+		private static int[] parse_cpu_list (string? text) {
+			int[] result = {};
+			if (text == null) return result;
+			string[] parts = text.strip().split(",");
+			foreach (unowned string part in parts) {
+				string[] range = part.split("-", 2);
+				int first, last;
+				if (!parse_int(range[0], out first)) continue;
+				if (range.length == 1) {
+					last = first;
+				} else if (!parse_int(range[1], out last) || last < first) {
+					continue;
+				}
+				for (int i = first; i <= last; i++) result += i;
+			}
+			return result;
+		}
+	}
+}
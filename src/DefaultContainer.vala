@@ -22,10 +22,11 @@ namespace Gpseq {
 	/**
 	 * Default container implementation.
 	 */
-	internal class DefaultContainer<G> : Object, Spliterator<G>, Container<G,G> {
+	internal class DefaultContainer<G> : Object, Spliterator<G>, Container<G,G>, SplitHint {
 		private Spliterator<G> _spliterator; // may be a Container
 		private Container<G,G>? _parent;
 		private Consumer<G> _consumer;
+		private SpliteratorCharacteristics _characteristics;
 
 		/**
 		 * Creates a new default container.
@@ -38,6 +39,10 @@ namespace Gpseq {
 			_spliterator = spliterator;
 			_parent = parent;
 			_consumer = consumer;
+			_characteristics = spliterator.characteristics;
+			if (!consumer.is_identity_function) {
+				_characteristics &= ~(SpliteratorCharacteristics.SIZED | SpliteratorCharacteristics.SUBSIZED);
+			}
 		}
 
 		protected Spliterator<G> spliterator {
@@ -70,6 +75,27 @@ namespace Gpseq {
 			}
 		}
 
+		/**
+		 * Sets the characteristics of this container.
+		 *
+		 * The characteristics are determined when the pipeline is built, and
+		 * remain unchanged even if {@link spliterator} is replaced.
+		 */
+		protected void set_characteristics (SpliteratorCharacteristics characteristics) {
+			_characteristics = characteristics;
+		}
+
+		/**
+		 * Makes the traversal of {@link spliterator} check the given guard
+		 * periodically.
+		 *
+		 * This is used on the source container of a pipeline, before the
+		 * pipeline is started.
+		 */
+		internal void guard (CancelGuard guard) {
+			_spliterator = new GuardedSpliterator<G>(_spliterator, guard);
+		}
+
 		public virtual Future<void*> start (Seq seq) {
 			var future = parent != null ? parent.start(seq) : Future.of<void*>(null);
 			set_parent(null);
@@ -81,7 +107,9 @@ namespace Gpseq {
 			if (spliter == null) {
 				return null;
 			} else {
-				return make_container(spliter);
+				DefaultContainer<G> container = make_container(spliter);
+				container._characteristics = _characteristics;
+				return container;
 			}
 		}
 
@@ -111,6 +139,18 @@ namespace Gpseq {
 			}
 		}
 
+		public virtual bool is_oversized {
+			get {
+				return SplitHint.of<G>(_spliterator);
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return _characteristics;
+			}
+		}
+
 		public virtual void each (Func<G> f) throws Error {
 			Func<G> func = _consumer.function(g => f(g));
 			_spliterator.each(func);
@@ -149,5 +189,64 @@ namespace Gpseq {
 				return _spliterator.each_chunk(loop_func);
 			}
 		}
+
+		/**
+		 * Stores the remaining elements of {@link spliterator} in a new array,
+		 * in encounter order.
+		 *
+		 * This is used by stateful containers which need all the elements of
+		 * their input before their own traversal.
+		 *
+		 * @return a new array of the elements
+		 */
+		protected G[] spliter_to_array () throws Error {
+			G[] array;
+			if (!spliterator.is_size_known || spliterator.estimated_size < 0) {
+				// the estimate is only an upper bound (e.g. of a filtered input),
+				// so start small and grow as needed
+				int64 estimate = spliterator.estimated_size;
+				array = new G[estimate > 0 ? (int) int64.min(estimate, ARRAY_CHUNK_SIZE) : 0];
+				int i = 0;
+				spliterator.each(g => {
+					if (i >= MAX_ARRAY_LENGTH) {
+						error("Seq exceeds max array length");
+					} else if (i >= array.length) {
+						int64 next_len = next_pot(i);
+						if (next_len > MAX_ARRAY_LENGTH || next_len < 0) {
+							next_len = (int64)MAX_ARRAY_LENGTH;
+						}
+						array.resize((int) next_len);
+					}
+					array[i++] = g;
+				});
+				if (array.length != i) array.resize(i);
+			} else if (spliterator.estimated_size > 0) {
+				if (spliterator.estimated_size > MAX_ARRAY_LENGTH) {
+					error("Seq exceeds max array length");
+				}
+				array = new G[spliterator.estimated_size];
+				int i = 0;
+				spliterator.each(g => {
+					array[i++] = g;
+				});
+			} else { // spliterator.estimated_size == 0
+				array = {};
+			}
+			return array;
+		}
+
+		/**
+		 * Finds next power of two, which is greater than and not equal to n.
+		 * @return next power of two, which is greater than and not equal to n
+		 */
+		private inline int64 next_pot (int64 n) {
+			n |= n >> 1;
+			n |= n >> 2;
+			n |= n >> 4;
+			n |= n >> 8;
+			n |= n >> 16;
+			n |= n >> 32;
+			return (n > int64.MAX - 1) ? -1 : ++n;
+		}
 	}
 }
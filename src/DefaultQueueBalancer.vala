@@ -43,7 +43,14 @@ namespace Gpseq {
 			// No need to use CAS here; no need to check accurately
 			if (pool.max_seekers > pool.seekers) {
 				pool.begin_seeking();
-				if (!try_steal(context)) try_drain_submissions(context);
+				// high priority submissions, stealing, then the others
+				bool taken = try_drain_submissions(context, pool.urgent_queue)
+						|| try_steal(context)
+						|| try_drain_submissions(context, pool.submission_queue)
+						|| try_drain_submissions(context, pool.background_queue);
+				if (!taken && pool.stats_enabled) {
+					context.counters.steal_failed();
+				}
 				pool.end_seeking();
 			}
 		}
@@ -51,7 +58,7 @@ namespace Gpseq {
 		/**
 		 * @return whether or not tasks are taken successfully
 		 */
-		private bool try_steal (WorkerContext context) {
+		protected virtual bool try_steal (WorkerContext context) {
 			int size = context.pool.parallels;
 			if (size <= 1) return false;
 			int start = _rand.int_range(0, size);
@@ -59,37 +66,55 @@ namespace Gpseq {
 		}
 
 		private bool do_steal (WorkerContext stealer, int search_start) {
-			WorkQueue sq = stealer.work_queue;
 			Gee.List<WorkerContext> contexts = stealer.pool.contexts;
 			int len = contexts.size;
 			for (long i = search_start, n = search_start + len; i < n; i++) {
 				int idx = (int) (i % len);
-				WorkerContext victim = contexts[idx];
-				WorkQueue vq = victim.work_queue;
-				int size = vq.size;
-				// If blocked, steals all the tasks.
-				// Otherwise, steals half the tasks.
-				if (size > 1 && !victim.is_blocked) size = size >> 1;
-				bool taken = false;
-				while (size > 0) {
-					Task? task = vq.poll_head();
-					if (task == null) break;
-					sq.offer_tail(task);
-					size--;
-					taken = true;
-				}
-				if (taken) return true;
+				if ( steal_from(stealer, contexts[idx]) ) return true;
 			}
 			return false;
 		}
 
-		private void try_drain_submissions (WorkerContext context) {
+		/**
+		 * Steals tasks from the work queue of the victim.
+		 *
+		 * @return whether or not tasks are taken successfully
+		 */
+		protected bool steal_from (WorkerContext stealer, WorkerContext victim) {
+			if (stealer == victim) return false;
+			WorkQueue sq = stealer.work_queue;
+			WorkQueue vq = victim.work_queue;
+			int size = vq.size;
+			// If blocked, steals all the tasks.
+			// Otherwise, steals half the tasks.
+			if (size > 1 && !victim.is_blocked) size = size >> 1;
+			int taken = vq.steal_to(sq, size);
+			if (taken > 0 && stealer.pool.stats_enabled) {
+				stealer.counters.tasks_stolen(taken);
+			}
+			return taken > 0;
+		}
+
+		/**
+		 * A random number generator owned by the context.
+		 */
+		protected Rand rand {
+			get {
+				return _rand;
+			}
+		}
+
+		/**
+		 * @return whether or not tasks are taken successfully
+		 */
+		private bool try_drain_submissions (WorkerContext context, SubmissionQueue queue) {
 			WorkerPool pool = context.pool;
-			for (int i = 0; i < DRAIN_CAPACITY; i++) {
-				Task? task = pool.submission_queue.poll_head();
-				if (task == null) break;
-				context.work_queue.offer_tail(task);
+			if (queue.is_empty) return false;
+			int taken = queue.drain_to(context.work_queue, DRAIN_CAPACITY, (uint) _rand.next_int());
+			if (taken > 0 && pool.stats_enabled) {
+				context.counters.submissions_drained(taken);
 			}
+			return taken > 0;
 		}
 	}
 }
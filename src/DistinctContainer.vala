@@ -27,6 +27,7 @@ namespace Gpseq {
 	internal class DistinctContainer<G> : DefaultContainer<G> {
 		private HashDataFunc<G>? _hash;
 		private EqualDataFunc<G>? _equal;
+		private bool _adjacent;
 		private bool _started;
 
 		/**
@@ -35,12 +36,23 @@ namespace Gpseq {
 		 * @param parent the parent of the new container
 		 * @param hash a //non-interfering// and //stateless// hash function
 		 * @param equal a //non-interfering// and //stateless// equal function
+		 * @param natural whether or not //hash// and //equal// are the default
+		 * functions of the element type
 		 */
 		public DistinctContainer (Spliterator<G> spliterator, Container<G,void*> parent,
-				owned HashDataFunc<G> hash, owned EqualDataFunc<G> equal) {
+				owned HashDataFunc<G> hash, owned EqualDataFunc<G> equal, bool natural) {
 			base(spliterator, parent, new Consumer<G>());
 			_hash = (owned) hash;
 			_equal = (owned) equal;
+
+			SpliteratorCharacteristics input = spliterator.characteristics;
+			// a sorted input has equal elements adjacent to each other, only if
+			// the sort and this distinct both use the defaults
+			_adjacent = natural && SpliteratorCharacteristics.SORTED in input;
+			SpliteratorCharacteristics c = input;
+			c &= ~(SpliteratorCharacteristics.SIZED | SpliteratorCharacteristics.SUBSIZED);
+			if (natural) c |= SpliteratorCharacteristics.DISTINCT;
+			set_characteristics(c);
 		}
 
 		private DistinctContainer.copy (DistinctContainer<G> container, Spliterator<G> spliterator) {
@@ -68,35 +80,37 @@ namespace Gpseq {
 		}
 
 		private Future<void*> perform_parallel (Seq seq) {
-			// TODO implement lock-free hash set/map
-			Set<G> seen = new HashSet<G>((owned) _hash, (owned) _equal);
-			Func<G> func = (g) => add_to_set(g, seen);
+			int parallels = seq.task_env.executor.parallels;
 			int64 len = estimated_size;
-			int64 threshold = seq.task_env.resolve_threshold(len, seq.task_env.executor.parallels);
-			int max_depth = seq.task_env.resolve_max_depth(len, seq.task_env.executor.parallels);
-			ForEachTask<G> task = new ForEachTask<G>(
-					func, spliterator, null,
-					threshold, max_depth, seq.task_env.executor);
+			int64 threshold = seq.task_env.resolve_threshold(len, parallels);
+			int max_depth = seq.task_env.resolve_max_depth(len, parallels);
+			DistinctTask<G> task;
+			if (_adjacent) {
+				task = new DistinctTask<G>.adjacent(
+						_equal, spliterator, null,
+						threshold, max_depth, seq.task_env.executor);
+			} else {
+				var seen = new ConcurrentHashSet<G>((owned) _hash, (owned) _equal, parallels);
+				task = new DistinctTask<G>(
+						seen, spliterator, null,
+						threshold, max_depth, seq.task_env.executor);
+			}
 			task.fork();
 			return (Future<void*>) task.future.map<void*>(value => {
-				spliterator = new IteratorSpliterator<G>.from_collection(seen);
+				spliterator = new ArrayBufferSpliterator<G>(value, 0, value.size);
 				_started = true;
 				return null;
 			});
 		}
 
-		private void add_to_set (G g, Set<G> seen) {
-			lock (_hash) {
-				seen.add(g);
-			}
-		}
-
 		private Future<void*> perform_sequential () {
-			// XXX optimize distinct() of sorted container
-			// sorted container doesn't need to store all seen elements but only
-			// a last seen element. the optimization needs to add 'attributes'
-			// flags property to spliterator.
-			consumer = new SequentialDistinctConsumer<G>((owned) _hash, (owned) _equal);
+			if (_adjacent) {
+				// a sorted input doesn't need to store all seen elements but
+				// only a last seen element
+				consumer = new AdjacentDistinctConsumer<G>((owned) _equal);
+			} else {
+				consumer = new SequentialDistinctConsumer<G>((owned) _hash, (owned) _equal);
+			}
 			_started = true;
 			return Future.of<void*>(null);
 		}
@@ -107,6 +121,32 @@ namespace Gpseq {
 			}
 		}
 
+		private class AdjacentDistinctConsumer<G> : Consumer<G> {
+			private EqualDataFunc<G> _equal;
+			private G? _last;
+			private bool _has_last;
+
+			public AdjacentDistinctConsumer (owned EqualDataFunc<G> equal) {
+				_equal = (owned) equal;
+			}
+
+			public override Func<G> function (owned Func<G> f) {
+				return (g) => {
+					if (!_has_last || !_equal(_last, g)) {
+						_last = g;
+						_has_last = true;
+						f(g);
+					}
+				};
+			}
+
+			public override bool is_identity_function {
+				get {
+					return false;
+				}
+			}
+		}
+
 		private class SequentialDistinctConsumer<G> : Consumer<G> {
 			private Set<G> _seen; // freed when the container is freed
 
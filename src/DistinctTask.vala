@@ -0,0 +1,136 @@
+/* DistinctTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A fork-join task that collects the distinct elements of a spliterator.
+	 *
+	 * Each leaf keeps the elements it has added to the shared set first, in
+	 * the encounter order, and the results are concatenated so that they can
+	 * be split again by the following stages.
+	 *
+	 * If the input is sorted, equal elements are adjacent and the task is
+	 * created with {@link DistinctTask.adjacent}. Then each leaf only
+	 * remembers the last element, and duplicates across the leaves are
+	 * removed when the results are merged.
+	 */
+	internal class DistinctTask<G> : SpliteratorTask<ArrayBuffer<G>,G> {
+		private ConcurrentHashSet<G>? _seen;
+		private unowned EqualDataFunc<G>? _equal;
+
+		/**
+		 * Creates a new distinct task.
+		 *
+		 * @param seen a set shared by all tasks
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public DistinctTask (
+				ConcurrentHashSet<G> seen,
+				Spliterator<G> spliterator, DistinctTask<G>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(spliterator, parent, threshold, max_depth, executor);
+			_seen = seen;
+		}
+
+		/**
+		 * Creates a new distinct task for a sorted input.
+		 *
+		 * @param equal a //non-interfering// and //stateless// equal function
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public DistinctTask.adjacent (
+				EqualDataFunc<G> equal,
+				Spliterator<G> spliterator, DistinctTask<G>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(spliterator, parent, threshold, max_depth, executor);
+			_equal = equal;
+		}
+
+		protected override ArrayBuffer<G> empty_result {
+			owned get {
+				return new ArrayBuffer<G>({});
+			}
+		}
+
+		protected override ArrayBuffer<G> leaf_compute () throws Error {
+			int64 estimated_remaining = int64.max(0, spliterator.estimated_size);
+			int size = estimated_remaining <= MAX_ARRAY_LENGTH ? (int)estimated_remaining : MAX_ARRAY_LENGTH;
+			G[] array = new G[size];
+			int idx = 0;
+			spliterator.each(g => {
+				if (_seen != null) {
+					if (!_seen.add(g)) return;
+				} else if (idx > 0 && _equal(array[idx - 1], g)) {
+					return;
+				}
+				if (idx >= MAX_ARRAY_LENGTH) {
+					error("DistinctTask exceeds max array length");
+				} else if (idx >= array.length) {
+					int64 next_len = int64.max(16, (int64)array.length << 1);
+					if (next_len > MAX_ARRAY_LENGTH) {
+						next_len = (int64)MAX_ARRAY_LENGTH;
+					}
+					array.resize((int) next_len);
+				}
+				array[idx++] = g;
+			});
+			if (array.length != idx) array.resize(idx);
+			return new ArrayBuffer<G>((owned) array);
+		}
+
+		protected override ArrayBuffer<G> merge_results (
+				owned ArrayBuffer<G> left, owned ArrayBuffer<G> right) throws Error {
+			if (_seen == null && left.size > 0 && right.size > 0
+					&& _equal(left[left.size - 1], right[0])) {
+				right = right.slice(1, right.size);
+			}
+			if (left.size == 0) {
+				return right;
+			} else if (right.size == 0) {
+				return left;
+			} else {
+				return new ConcatArrayBuffer<G>(left, right);
+			}
+		}
+
+		protected override SpliteratorTask<ArrayBuffer<G>,G> make_child (Spliterator<G> spliterator) {
+			DistinctTask<G> task;
+			if (_seen != null) {
+				task = new DistinctTask<G>(_seen,
+						spliterator, this, threshold, max_depth, executor);
+			} else {
+				task = new DistinctTask<G>.adjacent(_equal,
+						spliterator, this, threshold, max_depth, executor);
+			}
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
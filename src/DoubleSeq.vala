@@ -0,0 +1,238 @@
+/* DoubleSeq.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A sequence of double values backed by a contiguous array, supporting
+	 * sequential and parallel aggregate operations.
+	 *
+	 * Unlike a {@link Seq} of //double?//, the values are not boxed, and the
+	 * terminal operations run simple loops over the array. DoubleSeq has no
+	 * intermediate operations, so it is not closed by terminal operations
+	 * and can be used repeatedly.
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class DoubleSeq : Object {
+		private double[]? _array; // null if not owned
+		private double* _data;
+		private int _length;
+		private DoubleSeq? _base; // keeps the data alive
+		private TaskEnv _task_env;
+		private bool _is_parallel;
+
+		/**
+		 * Creates a new sequential seq of the given array.
+		 *
+		 * The array must not be modified while this seq, or any seq derived
+		 * from it, is used.
+		 *
+		 * @param array a double array
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 */
+		public static DoubleSeq of_array (double[] array, TaskEnv? env = null) {
+			return new DoubleSeq.with_data((double*) array, array.length, env);
+		}
+
+		/**
+		 * Creates a new sequential seq of the given array.
+		 *
+		 * This method steals the ownership of the array. The array will be
+		 * freed when the seq, and all seqs derived from it, are freed.
+		 *
+		 * @param array a double array
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 */
+		public static DoubleSeq of_owned_array (owned double[] array, TaskEnv? env = null) {
+			// must take length first, before ownership transferred
+			int len = array.length;
+			var seq = new DoubleSeq.with_data((double*) array, len, env);
+			seq._array = (owned) array;
+			return seq;
+		}
+
+		private DoubleSeq.with_data (double* data, int length, TaskEnv? env) {
+			_data = data;
+			_length = length;
+			_task_env = env != null ? env : TaskEnv.get_common_task_env();
+		}
+
+		private DoubleSeq.from_other (DoubleSeq seq, bool parallel) {
+			_data = seq._data;
+			_length = seq._length;
+			_base = seq._base != null ? seq._base : seq;
+			_task_env = seq._task_env;
+			_is_parallel = parallel;
+		}
+
+		/**
+		 * The raw data of this seq.
+		 */
+		internal double* data {
+			get {
+				return _data;
+			}
+		}
+
+		/**
+		 * The number of values.
+		 */
+		public int length {
+			get {
+				return _length;
+			}
+		}
+
+		/**
+		 * The task environment of this seq.
+		 */
+		public TaskEnv task_env {
+			get {
+				return _task_env;
+			}
+		}
+
+		/**
+		 * Whether or not this seq is in parallel mode.
+		 */
+		public bool is_parallel {
+			get {
+				return _is_parallel;
+			}
+		}
+
+		/**
+		 * Returns a new equivalent seq that is sequential.
+		 *
+		 * @return a new equivalent seq that is sequential
+		 */
+		public DoubleSeq sequential () {
+			return new DoubleSeq.from_other(this, false);
+		}
+
+		/**
+		 * Returns a new equivalent seq that is parallel.
+		 *
+		 * @return a new equivalent seq that is parallel
+		 */
+		public DoubleSeq parallel () {
+			return new DoubleSeq.from_other(this, true);
+		}
+
+		/**
+		 * Returns the count of values in this seq.
+		 *
+		 * @return a future of the count of values
+		 */
+		public Future<int64?> count () {
+			return Future.of<int64?>(_length);
+		}
+
+		/**
+		 * Returns the sum of the values in this seq. If there are no values,
+		 * the result is 0.
+		 *
+		 * The values may be summed in any order, so the result may differ
+		 * slightly from that of sequential summation.
+		 *
+		 * @return a future of the sum
+		 */
+		public Future<double?> sum () {
+			return (Future<double?>) summarize(SummaryOps.SUM, null)
+				.map<double?>(s => s.sum);
+		}
+
+		/**
+		 * Returns the arithmetic mean of the values in this seq. If there are
+		 * no values, the result is 0.
+		 *
+		 * @return a future of the arithmetic mean
+		 */
+		public Future<double?> average () {
+			return (Future<double?>) summarize(SummaryOps.AVERAGE, null)
+				.map<double?>(s => s.count == 0 ? 0 : s.sum / s.count);
+		}
+
+		/**
+		 * Returns the minimum value of this seq.
+		 *
+		 * The result is unspecified if the seq contains NaN.
+		 *
+		 * @return a future of an optional describing the minimum value, or an
+		 * empty optional if the seq is empty
+		 */
+		public Future<Optional<double?>> min () {
+			return (Future<Optional<double?>>) summarize(SummaryOps.MIN_MAX, null)
+				.map<Optional<double?>>(s => {
+					return s.count == 0 ? new Optional<double?>.empty() : new Optional<double?>.of(s.min);
+				});
+		}
+
+		/**
+		 * Returns the maximum value of this seq.
+		 *
+		 * The result is unspecified if the seq contains NaN.
+		 *
+		 * @return a future of an optional describing the maximum value, or an
+		 * empty optional if the seq is empty
+		 */
+		public Future<Optional<double?>> max () {
+			return (Future<Optional<double?>>) summarize(SummaryOps.MIN_MAX, null)
+				.map<Optional<double?>>(s => {
+					return s.count == 0 ? new Optional<double?>.empty() : new Optional<double?>.of(s.max);
+				});
+		}
+
+		/**
+		 * Returns a histogram of the values in this seq.
+		 *
+		 * @param lower the inclusive lower bound of the first bin
+		 * @param upper the exclusive upper bound of the last bin
+		 * @param bins the number of bins
+		 * @return a future of the histogram
+		 */
+		public Future<Histogram> histogram (double lower, double upper, int bins)
+			requires (lower < upper)
+			requires (bins > 0)
+		{
+			var shape = new Histogram(lower, upper, bins);
+			return (Future<Histogram>) summarize(SummaryOps.HISTOGRAM, shape)
+				.map<Histogram>(s => s.histogram);
+		}
+
+		private Future<DoubleSummaryTask.Summary> summarize (SummaryOps ops, Histogram? shape) {
+			if (!_is_parallel) {
+				return Future.of<DoubleSummaryTask.Summary>(
+						DoubleSummaryTask.compute_range(_data, 0, _length, ops, shape) );
+			}
+			int parallels = _task_env.executor.parallels;
+			int64 threshold = _task_env.resolve_threshold(_length, parallels);
+			int max_depth = _task_env.resolve_max_depth(_length, parallels);
+			var task = new DoubleSummaryTask(this, ops, shape,
+					0, _length, null,
+					threshold, max_depth, _task_env.executor);
+			task.fork();
+			return task.future;
+		}
+	}
+}
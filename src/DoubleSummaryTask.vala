@@ -0,0 +1,156 @@
+/* DoubleSummaryTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A fork-join task that computes statistics of a double array.
+	 *
+	 * Each statistic requested by the ops is computed in its own loop over
+	 * the raw array, so that the loops are simple enough to be vectorized by
+	 * the C compiler.
+	 */
+	internal class DoubleSummaryTask : RangeTask<DoubleSummaryTask.Summary> {
+		private DoubleSeq _seq; // keeps the data alive
+		private double* _data;
+		private SummaryOps _ops;
+		private Histogram? _shape;
+
+		/**
+		 * Creates a new double summary task.
+		 *
+		 * @param seq the seq that owns the data
+		 * @param ops the statistics to compute
+		 * @param shape an empty histogram whose bins are used if ops contains
+		 * HISTOGRAM
+		 * @param start zero-based index of the begin
+		 * @param end zero-based index after the end
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public DoubleSummaryTask (DoubleSeq seq, SummaryOps ops, Histogram? shape,
+				int start, int end, DoubleSummaryTask? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(start, end, parent, threshold, max_depth, executor);
+			_seq = seq;
+			_data = seq.data;
+			_ops = ops;
+			_shape = shape;
+		}
+
+		protected override Summary leaf_compute (int start, int end) throws Error {
+			return compute_range(_data, start, end, _ops, _shape);
+		}
+
+		protected override Summary merge_results (owned Summary left, owned Summary right) {
+			left.merge(right);
+			return left;
+		}
+
+		protected override RangeTask<Summary> make_child (int start, int end) {
+			var task = new DoubleSummaryTask(_seq, _ops, _shape,
+					start, end, this,
+					threshold, max_depth, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+
+		/**
+		 * Computes the statistics of the given range sequentially.
+		 */
+		public static Summary compute_range (double* data, int start, int end,
+				SummaryOps ops, Histogram? shape) {
+			Summary s = new Summary();
+			s.count = end - start;
+			if ((ops & (SummaryOps.SUM | SummaryOps.AVERAGE)) != 0) {
+				// four partial sums break the dependency chain between
+				// iterations, as floating-point addition is not reassociated
+				// by the compiler
+				double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+				int i = start;
+				for (; i + 3 < end; i += 4) {
+					s0 += data[i];
+					s1 += data[i+1];
+					s2 += data[i+2];
+					s3 += data[i+3];
+				}
+				for (; i < end; i++) {
+					s0 += data[i];
+				}
+				s.sum = (s0 + s1) + (s2 + s3);
+			}
+			if (SummaryOps.MIN_MAX in ops && start < end) {
+				double min = data[start];
+				double max = data[start];
+				for (int i = start + 1; i < end; i++) {
+					double v = data[i];
+					min = v < min ? v : min;
+					max = v > max ? v : max;
+				}
+				s.min = min;
+				s.max = max;
+			}
+			if (SummaryOps.HISTOGRAM in ops) {
+				Histogram hist = shape.copy_empty();
+				int64* counts = hist.counts;
+				int bins = hist.bins;
+				double lower = hist.lower;
+				double upper = hist.upper;
+				double scale = hist.scale;
+				int64 under = 0;
+				int64 over = 0;
+				for (int i = start; i < end; i++) {
+					double v = data[i];
+					if (v < lower) {
+						under++;
+					} else if (v < upper) {
+						int bin = (int) ((v - lower) * scale);
+						counts[bin < bins ? bin : bins - 1]++;
+					} else if (v >= upper) {
+						over++;
+					} // else NaN
+				}
+				hist.add_underflow(under);
+				hist.add_overflow(over);
+				s.histogram = hist;
+			}
+			return s;
+		}
+
+		public class Summary {
+			public int64 count;
+			public double sum;
+			public double min = double.INFINITY;
+			public double max = -double.INFINITY;
+			public Histogram? histogram;
+
+			public void merge (Summary other) {
+				if (other.count == 0) return;
+				sum += other.sum;
+				min = other.min < min ? other.min : min;
+				max = other.max > max ? other.max : max;
+				if (histogram != null) histogram.merge(other.histogram);
+				count += other.count;
+			}
+		}
+	}
+}
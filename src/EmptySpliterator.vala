@@ -48,5 +48,11 @@ namespace Gpseq {
 				return true;
 			}
 		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return SpliteratorCharacteristics.SIZED | SpliteratorCharacteristics.SUBSIZED;
+			}
+		}
 	}
 }
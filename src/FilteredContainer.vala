@@ -45,6 +45,26 @@ namespace Gpseq {
 			return new FilteredContainer<G>.copy(this, spliterator);
 		}
 
+		public override bool each_chunk (EachChunkFunc<G> f) throws Error {
+			FilteredConsumer<G> filter = (FilteredConsumer<G>) consumer;
+			int[]? selection = null;
+			G[]? array = null;
+			return spliterator.each_chunk(chunk => {
+				if (selection == null || selection.length < chunk.length) {
+					selection = new int[chunk.length];
+					array = new G[chunk.length];
+				}
+
+				int n = filter.select(chunk, selection);
+				if (n == 0) return true;
+				if (n == chunk.length) return f(chunk);
+				for (int i = 0; i < n; i++) {
+					array[i] = chunk[selection[i]];
+				}
+				return f(array[0:n]);
+			});
+		}
+
 		private class FilteredConsumer<G> : Consumer<G> {
 			private Predicate<G> _pred;
 
@@ -60,6 +80,23 @@ namespace Gpseq {
 				};
 			}
 
+			/**
+			 * Stores the indices of the elements of the chunk that match the
+			 * predicate into the selection vector, in ascending order.
+			 *
+			 * @param chunk a chunk of elements
+			 * @param selection a selection vector, at least as long as the
+			 * chunk
+			 * @return the number of the selected elements
+			 */
+			public int select (G[] chunk, int[] selection) throws Error {
+				int n = 0;
+				for (int i = 0; i < chunk.length; i++) {
+					if (_pred(chunk[i])) selection[n++] = i;
+				}
+				return n;
+			}
+
 			public override bool is_identity_function {
 				get {
 					return false;
@@ -96,6 +96,12 @@ namespace Gpseq {
 			}
 		}
 
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return _spliterator.characteristics & SpliteratorCharacteristics.ORDERED;
+			}
+		}
+
 		public void each (Func<R> f) throws Error {
 			if (_storage != null) {
 				foreach_iter(_storage, f);
@@ -61,8 +61,11 @@ namespace Gpseq {
 
 		protected override A leaf_compute () throws Error {
 			A result = _identity;
-			spliterator.each(g => {
-				result = _accumulator(g, result);
+			spliterator.each_chunk(chunk => {
+				for (int i = 0; i < chunk.length; i++) {
+					result = _accumulator(chunk[i], result);
+				}
+				return true;
 			});
 			return result;
 		}
@@ -0,0 +1,70 @@
+/* ForTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A task that applies a function to each index of a range, for
+	 * {@link parallel_for}.
+	 */
+	internal class ForTask : RangeTask<void*> {
+		private IndexFunc? _own_body; // held by the root task
+		private unowned IndexFunc _body;
+
+		/**
+		 * Creates a new root for task.
+		 *
+		 * @param body the function applied to each index
+		 * @param start the first index
+		 * @param end the index after the last one
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public ForTask (owned IndexFunc body, int start, int end,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(start, end, null, threshold, max_depth, executor);
+			_own_body = (owned) body;
+			_body = _own_body;
+		}
+
+		private ForTask.child (ForTask parent, int start, int end) {
+			base(start, end, parent, parent.threshold, parent.max_depth, parent.executor);
+			_body = parent._body;
+		}
+
+		protected override void* leaf_compute (int start, int end) throws Error {
+			for (int i = start; i < end; i++) {
+				_body(i);
+			}
+			return null;
+		}
+
+		protected override void* merge_results (owned void* left, owned void* right) {
+			return null;
+		}
+
+		protected override RangeTask<void*> make_child (int start, int end) {
+			var task = new ForTask.child(this, start, end);
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
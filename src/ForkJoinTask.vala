@@ -23,6 +23,11 @@ namespace Gpseq {
 	 * A base class for fork-join tasks that run within a worker pool.
 	 *
 	 * Note. Fork-join tasks are not reusable.
+	 *
+	 * The result of a task is kept in the task itself. The {@link future}
+	 * and {@link promise} objects are only created when they are accessed,
+	 * which is usually done only for the root task, so the internal nodes of
+	 * a task tree cost one object each.
 	 */
 	public abstract class ForkJoinTask<G> : Object, Task<G> {
 		private unowned ForkJoinTask<G>? _parent;
@@ -32,9 +37,18 @@ namespace Gpseq {
 		private int _depth;
 		private Executor _executor;
 
-		private Promise<G> _promise;
+		private const int PENDING = 0;
+		private const int READY = 1;
+		private const int ERROR = 2;
+		private const int LINKED = 3; // pending, and the promise has been created
+
+		private int _state;
+		private G? _value;
+		private Error? _error;
+		private Promise<G>? _promise;
+		private int _linking; // guards the creation of the promise
 		private SharedResult<G> _shared_result;
-		private AtomicBoolVal _cancelled;
+		private int _cancelled; // atomic bool
 
 		/**
 		 * Creates a fork-join task.
@@ -53,9 +67,7 @@ namespace Gpseq {
 			_threshold = threshold;
 			_max_depth = max_depth;
 			_executor = executor;
-			_promise = new Promise<G>();
 			_shared_result = parent == null ? new SharedResult<G>() : parent._shared_result;
-			_cancelled = new AtomicBoolVal();
 		}
 
 		/**
@@ -130,10 +142,13 @@ namespace Gpseq {
 
 		/**
 		 * The promise to set a result of {@link future}.
+		 *
+		 * {@link return_value} and {@link return_error} should be preferred,
+		 * since they do not create the promise.
 		 */
 		protected Promise<G> promise {
 			get {
-				return _promise;
+				return link_promise();
 			}
 		}
 
@@ -142,7 +157,92 @@ namespace Gpseq {
 		 */
 		public Future<G> future {
 			get {
-				return _promise.future;
+				return link_promise().future;
+			}
+		}
+
+		/**
+		 * {@inheritDoc}
+		 */
+		[Version (since="0.4.0-alpha")]
+		public bool is_done {
+			get {
+				int state = AtomicInt.get(ref _state);
+				if (state == LINKED) {
+					return _promise.future.ready;
+				}
+				return state != PENDING;
+			}
+		}
+
+		/**
+		 * Sets the value of this task.
+		 *
+		 * @param value the result value
+		 */
+		[Version (since="0.4.0-alpha")]
+		protected void return_value (owned G value) {
+			_value = (owned) value;
+			if ( !AtomicInt.compare_and_exchange(ref _state, PENDING, READY) ) {
+				// the future has been requested before the task was done
+				_promise.set_value(_value);
+			}
+		}
+
+		/**
+		 * Sets the error of this task.
+		 *
+		 * @param error the error
+		 */
+		[Version (since="0.4.0-alpha")]
+		protected void return_error (owned Error error) {
+			_error = (owned) error;
+			if ( !AtomicInt.compare_and_exchange(ref _state, PENDING, ERROR) ) {
+				// the future has been requested before the task was done
+				_promise.set_exception(_error.copy());
+			}
+		}
+
+		/**
+		 * Creates the promise if it has not been created, and links it to the
+		 * result of this task.
+		 */
+		private Promise<G> link_promise () {
+			// a spin lock; the promise is rarely created, and only once
+			while ( !AtomicInt.compare_and_exchange(ref _linking, 0, 1) ) {
+				Thread.yield();
+			}
+			if (_promise == null) {
+				var promise = new Promise<G>();
+				_promise = promise;
+				int state = AtomicInt.get(ref _state);
+				if ( state != PENDING || !AtomicInt.compare_and_exchange(ref _state, PENDING, LINKED) ) {
+					// already done, or done in the meantime
+					state = AtomicInt.get(ref _state);
+					if (state == READY) {
+						promise.set_value(_value);
+					} else {
+						promise.set_exception(_error.copy());
+					}
+				}
+			}
+			AtomicInt.set(ref _linking, 0);
+			return _promise;
+		}
+
+		/**
+		 * Computes this task immediately.
+		 *
+		 * @throws Error the error of this task
+		 */
+		public void invoke () throws Error {
+			compute();
+			if (AtomicInt.get(ref _state) == ERROR) {
+				throw _error.copy();
+			}
+			if (AtomicInt.get(ref _state) == LINKED) {
+				Error? err = _promise.future.exception;
+				if (err != null) throw err;
 			}
 		}
 
@@ -151,12 +251,29 @@ namespace Gpseq {
 		 * @throws Error an error occurred in the {@link future}
 		 */
 		public G join () throws Error {
-			WorkerThread? t = WorkerThread.self();
-			if (t == null) {
-				return external_join();
-			} else {
+			TaskTracer.trace(TaskTraceEvent.JOIN_BEGIN, this);
+			try {
+				return join_result();
+			} finally {
+				TaskTracer.trace(TaskTraceEvent.JOIN_END, this);
+			}
+		}
+
+		private G join_result () throws Error {
+			if (!is_done) {
+				WorkerThread? t = WorkerThread.self();
+				if (t == null) {
+					return external_join();
+				}
 				t.task_join(this);
-				return future.value;
+			}
+			switch (AtomicInt.get(ref _state)) {
+			case READY:
+				return _value;
+			case ERROR:
+				throw _error.copy();
+			default:
+				return _promise.future.wait();
 			}
 		}
 
@@ -172,6 +289,7 @@ namespace Gpseq {
 		 * Submits this task to the {@link executor}.
 		 */
 		public void fork () {
+			TaskTracer.trace(TaskTraceEvent.FORK, this);
 			_executor.submit(this);
 		}
 
@@ -190,7 +308,7 @@ namespace Gpseq {
 		 * Marks this task as cancelled.
 		 */
 		protected void cancel () {
-			_cancelled.val = true;
+			AtomicInt.set(ref _cancelled, 1);
 		}
 
 		/**
@@ -202,9 +320,9 @@ namespace Gpseq {
 		protected bool is_cancelled {
 			get {
 				ForkJoinTask<G>? p = parent;
-				bool cancelled = _cancelled.val;
+				bool cancelled = AtomicInt.get(ref _cancelled) == 1;
 				while (!cancelled && p != null) {
-					cancelled = p._cancelled.val;
+					cancelled = AtomicInt.get(ref p._cancelled) == 1;
 					p = p.parent;
 				}
 				return cancelled;
@@ -280,6 +398,25 @@ namespace Gpseq {
 					promise.set_exception((owned) _error);
 				}
 			}
+
+			/**
+			 * Sets the value or error to the given task, like
+			 * {@link bake_promise}.
+			 *
+			 * The ownership of the value or error is transferred to the
+			 * task, therefore this result should not be used after this
+			 * method called.
+			 */
+			[Version (since="0.4.0-alpha")]
+			public void bake (ForkJoinTask<G> task) {
+				int state = AtomicInt.get(ref _state);
+				assert(PENDING < state);
+				if (state == READY) {
+					task.return_value((owned) _value);
+				} else {
+					task.return_error((owned) _error);
+				}
+			}
 		}
 	}
 }
@@ -59,6 +59,17 @@ namespace Gpseq {
 			}
 		}
 
+		public bool each_chunk (EachChunkFunc<G> f) throws Error {
+			// the chunks are slices of the array; nothing is copied
+			while (_index + 1 < _stop) {
+				int start = _index + 1;
+				int stop = (int) int64.min((int64) start + ARRAY_CHUNK_SIZE, _stop);
+				_index = stop - 1;
+				if ( !f(_array.data[start:stop]) ) return false;
+			}
+			return true;
+		}
+
 		public int64 estimated_size {
 			get {
 				return _stop - (_index + 1);
@@ -70,5 +81,13 @@ namespace Gpseq {
 				return true;
 			}
 		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return SpliteratorCharacteristics.ORDERED
+					| SpliteratorCharacteristics.SIZED
+					| SpliteratorCharacteristics.SUBSIZED;
+			}
+		}
 	}
 }
@@ -22,6 +22,15 @@ namespace Gpseq {
 	internal const int MAX_ARRAY_LENGTH = int.MAX;
 
 	private const int64 SORT_THRESHOLD = 32768; // 1 << 15
+	/**
+	 * Seqs longer than this are sorted without a temporary array.
+	 */
+	internal const int64 IN_PLACE_SORT_THRESHOLD = 16777216; // 1 << 24
+	/**
+	 * The maximum length of the chunks that array spliterators pass to
+	 * {@link Spliterator.each_chunk} without copying.
+	 */
+	internal const int ARRAY_CHUNK_SIZE = 1024;
 
 	/**
 	 * Sorts the given array by comparing with the specified compare function,
@@ -76,6 +85,195 @@ namespace Gpseq {
 		}
 	}
 
+	/**
+	 * Sorts the given array by comparing with the specified compare function,
+	 * in parallel, without a temporary array. The sort is stable.
+	 *
+	 * This is the same as {@link parallel_sort} except that sorted runs are
+	 * merged in place by rotations, instead of through a temporary array of
+	 * the same length as the given array. The sort needs much less memory,
+	 * but takes more time.
+	 *
+	 * @param array a gpointer array to be sorted
+	 * @param compare compare function to compare elements. if it is not
+	 * specified, the result of {@link Gee.Functions.get_compare_func_for} is
+	 * used
+	 * @return a future which will be completed with a null value if the sort
+	 * succeeds, or with an exception if the sort fails because an error is
+	 * thrown from the compare function
+	 */
+	[Version (since="0.4.0-alpha")]
+	public Future<void*> parallel_sort_in_place<G> (G[] array, owned CompareDataFunc<G>? compare = null) {
+		int len = array.length;
+		SubArray<G> sub = new SubArray<G>(array);
+		if (len <= SORT_THRESHOLD) {
+			sub.sort((owned) compare);
+			return Future.of<void*>(null);
+		} else {
+			Comparator<G> cmp = new Comparator<G>((owned) compare);
+
+			TaskEnv env = TaskEnv.get_common_task_env();
+			Executor exe = env.executor;
+			int num_threads = exe.parallels;
+			int64 threshold = env.resolve_threshold(len, num_threads);
+			int max_depth = env.resolve_max_depth(len, num_threads);
+
+			SortTask<G> task = new SortTask<G>.in_place(sub, cmp, null, threshold, max_depth, exe);
+			task.fork();
+			return task.future;
+		}
+	}
+
+	/**
+	 * Sorts the given int64 array in ascending order, in parallel.
+	 *
+	 * This uses a radix sort, which does not compare elements.
+	 *
+	 * @param array an int64 array to be sorted
+	 * @return a future which will be completed with a null value when the
+	 * sort is done
+	 */
+	[Version (since="0.4.0-alpha")]
+	public Future<void*> parallel_sort_int64 (int64[] array) {
+		var sort = new RadixSort.for_int64((int64*) array, array.length, sort_parallels(array.length));
+		return run_radix_sort(sort, array.length);
+	}
+
+	/**
+	 * Sorts the given double array in ascending order, in parallel.
+	 *
+	 * This uses a radix sort, which does not compare elements. -0.0 is
+	 * ordered before 0.0, and NaN values are ordered after all other values
+	 * or, if their sign bits are set, before all other values.
+	 *
+	 * @param array a double array to be sorted
+	 * @return a future which will be completed with a null value when the
+	 * sort is done
+	 */
+	[Version (since="0.4.0-alpha")]
+	public Future<void*> parallel_sort_double (double[] array) {
+		var sort = new RadixSort.for_double((double*) array, array.length, sort_parallels(array.length));
+		return run_radix_sort(sort, array.length);
+	}
+
+	/**
+	 * Sorts the given array by the int64 keys extracted by the specified
+	 * function, in ascending order of the keys, in parallel. The sort is
+	 * stable.
+	 *
+	 * This uses a radix sort of the keys, which calls the key function once
+	 * per element and does not compare elements.
+	 *
+	 * @param array a gpointer array to be sorted
+	 * @param key a //stateless// function extracting the key of an element
+	 * @return a future which will be completed with a null value when the
+	 * sort is done
+	 */
+	[Version (since="0.4.0-alpha")]
+	public Future<void*> parallel_sort_by_key<G> (G[] array, owned KeyFunc<G> key) {
+		var sort = new RadixSort.keyed((void**) array, array.length,
+				p => key((G) p), sort_parallels(array.length));
+		return run_radix_sort(sort, array.length);
+	}
+
+	/**
+	 * Sorts the given string array in parallel, in the byte-wise order of
+	 * the strings, i.e. the order of GLib.strcmp.
+	 *
+	 * This uses multikey quicksort, which compares bytes directly instead of
+	 * calling a compare function. The array must not contain null.
+	 *
+	 * @param array a string array to be sorted
+	 * @return a future which will be completed with a null value when the
+	 * sort is done
+	 */
+	[Version (since="0.4.0-alpha")]
+	public Future<void*> parallel_sort_strings (string[] array) {
+		int len = array.length;
+		if (len <= SORT_THRESHOLD) {
+			StringSortTask.sort((uint8**) array, 0, len, 0);
+			return Future.of<void*>(null);
+		} else {
+			TaskEnv env = TaskEnv.get_common_task_env();
+			Executor exe = env.executor;
+			int num_threads = exe.parallels;
+			int64 threshold = env.resolve_threshold(len, num_threads);
+			int max_depth = env.resolve_max_depth(len, num_threads);
+
+			var task = new StringSortTask((uint8**) array, 0, len, 0, null, threshold, max_depth, exe);
+			task.fork();
+			return task.future;
+		}
+	}
+
+	private int sort_parallels (int length) {
+		return length <= SORT_THRESHOLD ? 1 : TaskEnv.get_common_task_env().executor.parallels;
+	}
+
+	private Future<void*> run_radix_sort (RadixSort sort, int length) {
+		if (length <= SORT_THRESHOLD) {
+			try {
+				sort.sort(null);
+			} catch (Error err) {
+				assert_not_reached(); // no error is thrown without an executor
+			}
+			return Future.of<void*>(null);
+		} else {
+			Executor exe = TaskEnv.get_common_task_env().executor;
+			return task<void*>(() => {
+				sort.sort(exe);
+				return null;
+			});
+		}
+	}
+
+	/**
+	 * Applies the given function to each index from //start// (inclusive) to
+	 * //end// (exclusive), in parallel.
+	 *
+	 * The range is split in half recursively on the executor of
+	 * {@link TaskEnv.get_common_task_env}, and each block of indices is
+	 * looped over directly; nothing is materialized. The function may be
+	 * applied to the indices in any order.
+	 *
+	 * {{{
+	 * double[] xs = new double[n];
+	 * parallel_for(0, n, i => { xs[i] = Math.sin(i); }).wait();
+	 * }}}
+	 *
+	 * @param start the first index
+	 * @param end the index after the last one
+	 * @param body the function applied to each index
+	 * @param grain the number of the indices looped over sequentially by
+	 * one task. if not positive, it is resolved by the task environment
+	 * @return a future which will be completed with a null value if all
+	 * indices are processed, or with the first error thrown by the function.
+	 * once the function throws, the blocks that have not started yet are
+	 * skipped
+	 */
+	[Version (since="0.4.0-alpha")]
+	public Future<void*> parallel_for (int start, int end, owned IndexFunc body, int grain = 0) {
+		if (start >= end) return Future.of<void*>(null);
+
+		int64 len = (int64) end - start;
+		TaskEnv env = TaskEnv.get_common_task_env();
+		Executor exe = env.executor;
+		int num_threads = exe.parallels;
+		int64 threshold;
+		int max_depth;
+		if (grain > 0) {
+			threshold = grain;
+			max_depth = -1;
+		} else {
+			threshold = env.resolve_threshold(len, num_threads);
+			max_depth = env.resolve_max_depth(len, num_threads);
+		}
+
+		ForTask task = new ForTask((owned) body, start, end, threshold, max_depth, exe);
+		task.fork();
+		return task.future;
+	}
+
 	/**
 	 * Schedules the given function to execute asynchronously.
 	 *
@@ -231,6 +429,21 @@ namespace Gpseq {
 		return { left_result, right_result };
 	}
 
+	/**
+	 * Sets the function that receives the fork/join events of all fork-join
+	 * tasks, or unsets it if null.
+	 *
+	 * Tracing is meant for diagnostics. The function is called on the hot
+	 * paths of the scheduler, so it slows down fork-join computations while
+	 * it is set.
+	 *
+	 * @param func a trace function, or null
+	 */
+	[Version (since="0.4.0-alpha")]
+	public void set_task_trace_func (owned TaskTraceFunc? func) {
+		TaskTracer.set_func((owned) func);
+	}
+
 	/**
 	 * Gets the current value of //atomic//.
 	 *
@@ -400,6 +613,9 @@ namespace Gpseq {
 	[CCode (cname="g_atomic_int_or", cheader_filename = "glib.h")]
 	private extern uint atomic_uint_or ([CCode (type="volatile guint *")] ref uint atomic, uint val);
 
+	[CCode (cname="gpseq_set_thread_affinity")]
+	internal extern bool set_thread_affinity (int cpu);
+
 	[Version (since="0.3.0-alpha")]
 	[CCode (cname="GpseqCacheLinePad", has_type_id=false)]
 	public extern struct CacheLinePad {}
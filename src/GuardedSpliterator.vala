@@ -0,0 +1,93 @@
+/* GuardedSpliterator.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A spliterator which checks a cancel guard periodically while
+	 * traversing the elements of another spliterator.
+	 *
+	 * Bulk traversals check the guard once per {@link CHECK_INTERVAL}
+	 * elements or once per chunk, so an interrupted traversal stops within
+	 * one chunk by throwing the error of {@link CancelGuard.check}.
+	 */
+	internal class GuardedSpliterator<G> : Object, Spliterator<G> {
+		private const int CHECK_INTERVAL = 1024;
+
+		private Spliterator<G> _spliterator;
+		private CancelGuard _guard;
+		private int _countdown;
+
+		public GuardedSpliterator (Spliterator<G> spliterator, CancelGuard guard) {
+			_spliterator = spliterator;
+			_guard = guard;
+			_countdown = CHECK_INTERVAL;
+		}
+
+		public Spliterator<G>? try_split () {
+			Spliterator<G>? split = _spliterator.try_split();
+			return split == null ? null : new GuardedSpliterator<G>(split, _guard);
+		}
+
+		public bool try_advance (Func<G> consumer) throws Error {
+			if (--_countdown <= 0) {
+				_countdown = CHECK_INTERVAL;
+				_guard.check();
+			}
+			return _spliterator.try_advance(consumer);
+		}
+
+		public int64 estimated_size {
+			get {
+				return _spliterator.estimated_size;
+			}
+		}
+
+		public bool is_size_known {
+			get {
+				return _spliterator.is_size_known;
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return _spliterator.characteristics;
+			}
+		}
+
+		public void each (Func<G> f) throws Error {
+			_guard.check();
+			_spliterator.each(g => {
+				if (--_countdown <= 0) {
+					_countdown = CHECK_INTERVAL;
+					_guard.check();
+				}
+				f(g);
+			});
+		}
+
+		public bool each_chunk (EachChunkFunc<G> f) throws Error {
+			_guard.check();
+			return _spliterator.each_chunk(chunk => {
+				_guard.check();
+				return f(chunk);
+			});
+		}
+	}
+}
@@ -0,0 +1,189 @@
+/* Histogram.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A histogram of numeric values, with bins of equal width.
+	 *
+	 * The range [{@link lower}, {@link upper}) is divided into
+	 * {@link bins} bins. Values less than //lower// are counted in
+	 * {@link underflow}, and values greater than or equal to //upper// are
+	 * counted in {@link overflow}. NaN values are not counted at all.
+	 *
+	 * @see Int64Seq.histogram
+	 * @see DoubleSeq.histogram
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class Histogram : Object {
+		private int64[] _counts;
+		private double _lower;
+		private double _upper;
+		private int64 _underflow;
+		private int64 _overflow;
+
+		internal Histogram (double lower, double upper, int bins)
+			requires (lower < upper)
+			requires (bins > 0)
+		{
+			_counts = new int64[bins];
+			_lower = lower;
+			_upper = upper;
+		}
+
+		/**
+		 * The inclusive lower bound of the first bin.
+		 */
+		public double lower {
+			get {
+				return _lower;
+			}
+		}
+
+		/**
+		 * The exclusive upper bound of the last bin.
+		 */
+		public double upper {
+			get {
+				return _upper;
+			}
+		}
+
+		/**
+		 * The number of bins.
+		 */
+		public int bins {
+			get {
+				return _counts.length;
+			}
+		}
+
+		/**
+		 * The width of each bin.
+		 */
+		public double bin_width {
+			get {
+				return (_upper - _lower) / _counts.length;
+			}
+		}
+
+		/**
+		 * The number of values less than {@link lower}.
+		 */
+		public int64 underflow {
+			get {
+				return _underflow;
+			}
+		}
+
+		/**
+		 * The number of values greater than or equal to {@link upper}.
+		 */
+		public int64 overflow {
+			get {
+				return _overflow;
+			}
+		}
+
+		/**
+		 * The number of counted values, including {@link underflow} and
+		 * {@link overflow}.
+		 */
+		public int64 total {
+			get {
+				int64 total = _underflow + _overflow;
+				for (int i = 0; i < _counts.length; i++) {
+					total += _counts[i];
+				}
+				return total;
+			}
+		}
+
+		/**
+		 * Gets the number of values in the given bin.
+		 *
+		 * @param bin zero-based index of the bin
+		 * @return the number of values in the bin
+		 */
+		public new int64 @get (int bin)
+			requires (0 <= bin < _counts.length)
+		{
+			return _counts[bin];
+		}
+
+		/**
+		 * Gets the inclusive lower bound of the given bin.
+		 *
+		 * @param bin zero-based index of the bin
+		 * @return the lower bound of the bin
+		 */
+		public double bin_lower (int bin)
+			requires (0 <= bin < _counts.length)
+		{
+			return _lower + bin * bin_width;
+		}
+
+		/**
+		 * The scale converting a value offset from {@link lower} into a bin
+		 * index.
+		 */
+		internal double scale {
+			get {
+				return _counts.length / (_upper - _lower);
+			}
+		}
+
+		/**
+		 * The bins, to which leaf loops add directly.
+		 */
+		internal int64* counts {
+			get {
+				return (int64*) _counts;
+			}
+		}
+
+		internal void add_underflow (int64 n) {
+			_underflow += n;
+		}
+
+		internal void add_overflow (int64 n) {
+			_overflow += n;
+		}
+
+		/**
+		 * Adds the counts of the other histogram, which has the same bins, to
+		 * this histogram.
+		 */
+		internal void merge (Histogram other) {
+			assert(_counts.length == other._counts.length);
+			for (int i = 0; i < _counts.length; i++) {
+				_counts[i] += other._counts[i];
+			}
+			_underflow += other._underflow;
+			_overflow += other._overflow;
+		}
+
+		/**
+		 * Creates a new empty histogram with the same bins as this.
+		 */
+		internal Histogram copy_empty () {
+			return new Histogram(_lower, _upper, _counts.length);
+		}
+	}
+}
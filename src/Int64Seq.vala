@@ -0,0 +1,257 @@
+/* Int64Seq.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A sequence of int64 values backed by a contiguous array, supporting
+	 * sequential and parallel aggregate operations.
+	 *
+	 * Unlike a {@link Seq} of //int64?//, the values are not boxed, and the
+	 * terminal operations run simple loops over the array. Int64Seq has no
+	 * intermediate operations, so it is not closed by terminal operations
+	 * and can be used repeatedly.
+	 *
+	 * Int values can be used via {@link Int64Seq.of_int_array}.
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class Int64Seq : Object {
+		private int64[]? _array; // null if not owned
+		private int64* _data;
+		private int _length;
+		private Int64Seq? _base; // keeps the data alive
+		private TaskEnv _task_env;
+		private bool _is_parallel;
+
+		/**
+		 * Creates a new sequential seq of the given array.
+		 *
+		 * The array must not be modified while this seq, or any seq derived
+		 * from it, is used.
+		 *
+		 * @param array an int64 array
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 */
+		public static Int64Seq of_array (int64[] array, TaskEnv? env = null) {
+			return new Int64Seq.with_data((int64*) array, array.length, env);
+		}
+
+		/**
+		 * Creates a new sequential seq of the given array.
+		 *
+		 * This method steals the ownership of the array. The array will be
+		 * freed when the seq, and all seqs derived from it, are freed.
+		 *
+		 * @param array an int64 array
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 */
+		public static Int64Seq of_owned_array (owned int64[] array, TaskEnv? env = null) {
+			// must take length first, before ownership transferred
+			int len = array.length;
+			var seq = new Int64Seq.with_data((int64*) array, len, env);
+			seq._array = (owned) array;
+			return seq;
+		}
+
+		/**
+		 * Creates a new sequential seq of the given int array.
+		 *
+		 * The values are copied into a new int64 array once, so the given
+		 * array may be modified after this method returns.
+		 *
+		 * @param array an int array
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 */
+		public static Int64Seq of_int_array (int[] array, TaskEnv? env = null) {
+			int64[] copy = new int64[array.length];
+			for (int i = 0; i < array.length; i++) {
+				copy[i] = array[i];
+			}
+			return of_owned_array((owned) copy, env);
+		}
+
+		private Int64Seq.with_data (int64* data, int length, TaskEnv? env) {
+			_data = data;
+			_length = length;
+			_task_env = env != null ? env : TaskEnv.get_common_task_env();
+		}
+
+		private Int64Seq.from_other (Int64Seq seq, bool parallel) {
+			_data = seq._data;
+			_length = seq._length;
+			_base = seq._base != null ? seq._base : seq;
+			_task_env = seq._task_env;
+			_is_parallel = parallel;
+		}
+
+		/**
+		 * The raw data of this seq.
+		 */
+		internal int64* data {
+			get {
+				return _data;
+			}
+		}
+
+		/**
+		 * The number of values.
+		 */
+		public int length {
+			get {
+				return _length;
+			}
+		}
+
+		/**
+		 * The task environment of this seq.
+		 */
+		public TaskEnv task_env {
+			get {
+				return _task_env;
+			}
+		}
+
+		/**
+		 * Whether or not this seq is in parallel mode.
+		 */
+		public bool is_parallel {
+			get {
+				return _is_parallel;
+			}
+		}
+
+		/**
+		 * Returns a new equivalent seq that is sequential.
+		 *
+		 * @return a new equivalent seq that is sequential
+		 */
+		public Int64Seq sequential () {
+			return new Int64Seq.from_other(this, false);
+		}
+
+		/**
+		 * Returns a new equivalent seq that is parallel.
+		 *
+		 * @return a new equivalent seq that is parallel
+		 */
+		public Int64Seq parallel () {
+			return new Int64Seq.from_other(this, true);
+		}
+
+		/**
+		 * Returns the count of values in this seq.
+		 *
+		 * @return a future of the count of values
+		 */
+		public Future<int64?> count () {
+			return Future.of<int64?>(_length);
+		}
+
+		/**
+		 * Returns the sum of the values in this seq. If there are no values,
+		 * the result is 0.
+		 *
+		 * The arithmetic wraps around on overflow.
+		 *
+		 * @return a future of the sum
+		 */
+		public Future<int64?> sum () {
+			return (Future<int64?>) summarize(SummaryOps.SUM, null)
+				.map<int64?>(s => s.sum);
+		}
+
+		/**
+		 * Returns the arithmetic mean of the values in this seq. If there are
+		 * no values, the result is 0.
+		 *
+		 * The values are summed in double precision, so this does not
+		 * overflow.
+		 *
+		 * @return a future of the arithmetic mean
+		 */
+		public Future<double?> average () {
+			return (Future<double?>) summarize(SummaryOps.AVERAGE, null)
+				.map<double?>(s => s.count == 0 ? 0 : s.total / s.count);
+		}
+
+		/**
+		 * Returns the minimum value of this seq.
+		 *
+		 * @return a future of an optional describing the minimum value, or an
+		 * empty optional if the seq is empty
+		 */
+		public Future<Optional<int64?>> min () {
+			return (Future<Optional<int64?>>) summarize(SummaryOps.MIN_MAX, null)
+				.map<Optional<int64?>>(s => {
+					return s.count == 0 ? new Optional<int64?>.empty() : new Optional<int64?>.of(s.min);
+				});
+		}
+
+		/**
+		 * Returns the maximum value of this seq.
+		 *
+		 * @return a future of an optional describing the maximum value, or an
+		 * empty optional if the seq is empty
+		 */
+		public Future<Optional<int64?>> max () {
+			return (Future<Optional<int64?>>) summarize(SummaryOps.MIN_MAX, null)
+				.map<Optional<int64?>>(s => {
+					return s.count == 0 ? new Optional<int64?>.empty() : new Optional<int64?>.of(s.max);
+				});
+		}
+
+		/**
+		 * Returns a histogram of the values in this seq.
+		 *
+		 * @param lower the inclusive lower bound of the first bin
+		 * @param upper the exclusive upper bound of the last bin
+		 * @param bins the number of bins
+		 * @return a future of the histogram
+		 */
+		public Future<Histogram> histogram (double lower, double upper, int bins)
+			requires (lower < upper)
+			requires (bins > 0)
+		{
+			var shape = new Histogram(lower, upper, bins);
+			return (Future<Histogram>) summarize(SummaryOps.HISTOGRAM, shape)
+				.map<Histogram>(s => s.histogram);
+		}
+
+		private Future<Int64SummaryTask.Summary> summarize (SummaryOps ops, Histogram? shape) {
+			if (!_is_parallel) {
+				return Future.of<Int64SummaryTask.Summary>(
+						Int64SummaryTask.compute_range(_data, 0, _length, ops, shape) );
+			}
+			int parallels = _task_env.executor.parallels;
+			int64 threshold = _task_env.resolve_threshold(_length, parallels);
+			int max_depth = _task_env.resolve_max_depth(_length, parallels);
+			var task = new Int64SummaryTask(this, ops, shape,
+					0, _length, null,
+					threshold, max_depth, _task_env.executor);
+			task.fork();
+			return task.future;
+		}
+	}
+}
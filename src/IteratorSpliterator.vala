@@ -123,5 +123,17 @@ namespace Gpseq {
 				return _size_known;
 			}
 		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				if (_size_known && _estimated_size >= 0) {
+					return SpliteratorCharacteristics.ORDERED
+						| SpliteratorCharacteristics.SIZED
+						| SpliteratorCharacteristics.SUBSIZED;
+				} else {
+					return SpliteratorCharacteristics.ORDERED;
+				}
+			}
+		}
 	}
 }
@@ -0,0 +1,266 @@
+/* JoinContainer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+namespace Gpseq {
+	/**
+	 * A container which contains the results of a hash join of a input with
+	 * another seq.
+	 *
+	 * The other seq is collected into a {@link JoinTable} when the container
+	 * is started, and then the elements of the input are streamed through
+	 * the table; the input is split as usual, and the splits share the table.
+	 */
+	internal class JoinContainer<R,G,K,H> : Object, Spliterator<R>, Container<R,G> {
+		private const int CHUNK_SIZE = 128; // must be >= 1
+
+		private Spliterator<G> _spliterator; // may be a Container
+		private Container<G,void*>? _parent;
+		private JoinProbe<R,G,K,H> _probe;
+		private GenericArray<R> _pending; // outputs not yet consumed
+		private int _pending_index;
+
+		/**
+		 * Creates a new join container.
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new container
+		 * @param kind the kind of the join
+		 * @param other the seq of the build side
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * the input
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @param combiner a //non-interfering// and //stateless// function
+		 * combining the matched elements
+		 */
+		public JoinContainer (Spliterator<G> spliterator, Container<G,void*>? parent,
+				Kind kind, Seq<H> other, owned MapFunc<K,G> key, owned MapFunc<K,H> other_key,
+				owned JoinFunc<R,G,H> combiner) {
+			_spliterator = spliterator;
+			_parent = parent;
+			_probe = new JoinProbe<R,G,K,H>(kind, other, (owned) key, (owned) other_key, (owned) combiner);
+			_pending = new GenericArray<R>();
+		}
+
+		private JoinContainer.split (Spliterator<G> spliterator, JoinProbe<R,G,K,H> probe) {
+			_spliterator = spliterator;
+			_probe = probe;
+			_pending = new GenericArray<R>();
+		}
+
+		public Container<G,void*>? parent {
+			get {
+				return _parent;
+			}
+		}
+
+		public Future<void*> start (Seq seq) {
+			var future = _parent != null ? _parent.start(seq) : Future.of<void*>(null);
+			_parent = null;
+			return (Future<void*>) future.flat_map<void*>(value => {
+				return _probe.build(seq);
+			});
+		}
+
+		public Spliterator<R>? try_split () {
+			Spliterator<G>? source = _spliterator.try_split();
+			if (source == null) {
+				return null;
+			} else {
+				return new JoinContainer<R,G,K,H>.split(source, _probe);
+			}
+		}
+
+		public bool try_advance (Func<R> consumer) throws Error {
+			while (_pending_index >= _pending.length) {
+				clear_pending();
+				bool advanced = _spliterator.try_advance(g => {
+					_probe.probe(g, r => {
+						_pending.add(r);
+					});
+				});
+				if (!advanced) return false;
+			}
+			consumer(_pending[_pending_index++]);
+			return true;
+		}
+
+		public int64 estimated_size {
+			get {
+				return _spliterator.estimated_size;
+			}
+		}
+
+		public bool is_size_known {
+			get {
+				return false;
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				SpliteratorCharacteristics c = _spliterator.characteristics;
+				if (_probe.is_filter) {
+					return c & ~(SpliteratorCharacteristics.SIZED | SpliteratorCharacteristics.SUBSIZED);
+				} else {
+					return c & SpliteratorCharacteristics.ORDERED;
+				}
+			}
+		}
+
+		public void each (Func<R> f) throws Error {
+			while (_pending_index < _pending.length) {
+				f(_pending[_pending_index++]);
+			}
+			clear_pending();
+			_spliterator.each(g => {
+				_probe.probe(g, f);
+			});
+		}
+
+		public bool each_chunk (EachChunkFunc<R> f) throws Error {
+			if (!drain_pending(f)) return false;
+			return _spliterator.each_chunk(chunk => {
+				// the outputs are passed on as soon as a chunk of them is
+				// ready. once stopped, the outputs of the rest of the input
+				// chunk are kept for the next traversal
+				bool go = true;
+				for (int i = 0; i < chunk.length; i++) {
+					_probe.probe(chunk[i], r => {
+						_pending.add(r);
+						if (go && _pending.length - _pending_index >= CHUNK_SIZE) {
+							go = drain_pending(f);
+						}
+					});
+				}
+				return go && drain_pending(f);
+			});
+		}
+
+		private bool drain_pending (EachChunkFunc<R> f) throws Error {
+			while (_pending_index < _pending.length) {
+				int end = int.min(_pending_index + CHUNK_SIZE, _pending.length);
+				bool go = f(_pending.data[_pending_index:end]);
+				_pending_index = end;
+				if (!go) return false;
+			}
+			clear_pending();
+			return true;
+		}
+
+		private void clear_pending () {
+			if (_pending.length > 0) _pending.remove_range(0, _pending.length);
+			_pending_index = 0;
+		}
+
+		/**
+		 * The kinds of joins.
+		 */
+		public enum Kind {
+			/**
+			 * Each pair of matched elements.
+			 */
+			INNER,
+			/**
+			 * Each pair of matched elements, and the unmatched elements of the
+			 * input paired with null.
+			 */
+			LEFT,
+			/**
+			 * The elements of the input that have a match.
+			 */
+			SEMI,
+			/**
+			 * The elements of the input that have no match.
+			 */
+			ANTI
+		}
+	}
+
+	/**
+	 * The state of a join shared by a join container and its splits.
+	 */
+	internal class JoinProbe<R,G,K,H> : Object {
+		private JoinContainer.Kind _kind;
+		private Seq<H>? _other;
+		private MapFunc<K,G> _key;
+		private MapFunc<K,H>? _other_key;
+		private JoinFunc<R,G,H> _combiner;
+		private JoinTable<K,H>? _table;
+
+		public JoinProbe (JoinContainer.Kind kind, Seq<H> other, owned MapFunc<K,G> key,
+				owned MapFunc<K,H> other_key, owned JoinFunc<R,G,H> combiner) {
+			_kind = kind;
+			_other = other;
+			_key = (owned) key;
+			_other_key = (owned) other_key;
+			_combiner = (owned) combiner;
+		}
+
+		/**
+		 * Whether or not the join only selects elements of the input.
+		 */
+		public bool is_filter {
+			get {
+				return _kind == JoinContainer.Kind.SEMI || _kind == JoinContainer.Kind.ANTI;
+			}
+		}
+
+		/**
+		 * Collects the other seq into the table. The other seq is collected in
+		 * parallel if it or the given seq is parallel.
+		 */
+		public Future<void*> build (Seq seq) {
+			Seq<H> other = (owned) _other;
+			if (seq.is_parallel && !other.is_parallel) {
+				other = other.parallel();
+			}
+			int partitions = other.is_parallel
+					? JoinTable.resolve_partitions(other.task_env.executor.parallels)
+					: 1;
+			var collector = new Collectors.JoinTableCollector<K,H>(
+					(owned) _other_key, partitions, other.task_env.executor);
+			return (Future<void*>) other.collect<JoinTable<K,H>,Object>(collector).map<void*>(table => {
+				_table = table;
+				return null;
+			});
+		}
+
+		/**
+		 * Applies the given function to the outputs of the given element.
+		 */
+		public void probe (G g, Func<R> emit) throws Error {
+			K key = _key(g);
+			if (_kind == JoinContainer.Kind.SEMI) {
+				if (_table.contains(key)) emit(_combiner(g, null));
+			} else if (_kind == JoinContainer.Kind.ANTI) {
+				if (!_table.contains(key)) emit(_combiner(g, null));
+			} else {
+				bool matched = _table.each_match(key, h => {
+					emit(_combiner(g, h));
+				});
+				if (!matched && _kind == JoinContainer.Kind.LEFT) {
+					emit(_combiner(g, null));
+				}
+			}
+		}
+	}
+}
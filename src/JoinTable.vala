@@ -0,0 +1,282 @@
+/* JoinTable.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+namespace Gpseq {
+	/**
+	 * A read-only hash multimap for the build side of hash joins.
+	 *
+	 * The entries are hash-partitioned, and each partition is built by one
+	 * task without locks, from the entries gathered by the leaves of a
+	 * collect task. In a partition, the entries of a key form a list in
+	 * encounter order, and only the first entry of each key is linked in
+	 * the bucket chains, so a lookup does not walk over the duplicates of
+	 * other keys.
+	 */
+	internal class JoinTable<K,V> : Object {
+		private HashDataFunc<K> _hash;
+		private EqualDataFunc<K> _equal;
+		private Partition<K,V>?[] _partitions;
+		private int _shift; // log₂ of the number of partitions
+
+		/**
+		 * Creates a new join table whose partitions are not built yet.
+		 *
+		 * The keys are hashed and compared by the results of
+		 * {@link Gee.Functions.get_hash_func_for} and
+		 * {@link Gee.Functions.get_equal_func_for}.
+		 *
+		 * @param partitions the number of partitions. must be a power of two
+		 */
+		public JoinTable (int partitions)
+			requires (partitions > 0 && (partitions & (partitions - 1)) == 0)
+		{
+			_hash = Functions.get_hash_func_for(typeof(K));
+			_equal = Functions.get_equal_func_for(typeof(K));
+			_partitions = new Partition<K,V>?[partitions];
+			while ((1 << _shift) < partitions) _shift++;
+		}
+
+		/**
+		 * Gets the number of partitions for the given number of threads: a
+		 * power of two, large enough to balance the partitions among the
+		 * threads.
+		 */
+		public static int resolve_partitions (int parallels) {
+			int partitions = 1;
+			while (partitions < parallels * 4) partitions *= 2;
+			return partitions;
+		}
+
+		public int num_partitions {
+			get {
+				return _partitions.length;
+			}
+		}
+
+		/**
+		 * Hashes the given key. The higher bits are spread downward, since
+		 * the partition is chosen by the lowest bits.
+		 */
+		public uint hash_of (K key) {
+			uint h = _hash(key);
+			return h ^ (h >> 16);
+		}
+
+		public int partition_of (uint hash) {
+			return (int) (hash & (_partitions.length - 1));
+		}
+
+		public unowned Partition<K,V> get_partition (int i) {
+			return _partitions[i];
+		}
+
+		/**
+		 * Builds the i-th partition from the i-th entries of the given runs.
+		 *
+		 * Note. Each partition must be built by only one thread, and all
+		 * partitions must be built before the table is read.
+		 *
+		 * @param i the index of the partition
+		 * @param runs the entries gathered by the leaves, in encounter order
+		 */
+		public void build_partition (int i, Gee.List<JoinRun<K,V>> runs) {
+			_partitions[i] = new Partition<K,V>(runs, i, _shift, _equal);
+		}
+
+		/**
+		 * Finds the first entry of the given key.
+		 *
+		 * @param key the key
+		 * @param p the partition of the key, set on return
+		 * @return the index of the entry in //p//, or -1 if not found
+		 */
+		public int find (K key, out unowned Partition<K,V> p) {
+			uint h = hash_of(key);
+			p = _partitions[partition_of(h)];
+			return p.find(key, h, _equal);
+		}
+
+		/**
+		 * Finds the first entry of the given key in the given partition.
+		 *
+		 * @param partition the index of the partition
+		 * @param key the key
+		 * @param hash the result of {@link hash_of} for the key
+		 * @return the index of the entry, or -1 if not found
+		 */
+		public int find_in (int partition, K key, uint hash) {
+			return _partitions[partition].find(key, hash, _equal);
+		}
+
+		/**
+		 * Applies the given function to the values of the given key, in
+		 * encounter order.
+		 *
+		 * @return whether or not the key is contained
+		 */
+		public bool each_match (K key, Func<V> f) throws Error {
+			unowned Partition<K,V> p;
+			int e = find(key, out p);
+			if (e < 0) return false;
+			for (; e >= 0; e = p.next_same[e]) {
+				f(p.values[e]);
+			}
+			return true;
+		}
+
+		/**
+		 * Whether or not the given key is contained.
+		 */
+		public bool contains (K key) {
+			unowned Partition<K,V> p;
+			return find(key, out p) >= 0;
+		}
+
+		/**
+		 * The entries of a partition.
+		 */
+		internal class Partition<K,V> : Object {
+			public K[] keys;
+			public V[] values;
+			public uint[] hashes;
+			/**
+			 * The next entry of the same key, or -1.
+			 */
+			public int[] next_same;
+			/**
+			 * The first entries of the keys, in encounter order.
+			 */
+			public int[] heads;
+			public int num_heads;
+
+			private int[] _next_head; // the next first entry in the bucket
+			private int[] _buckets;
+			private int _shift;
+
+			public Partition (Gee.List<JoinRun<K,V>> runs, int index, int shift,
+					EqualDataFunc<K> equal) {
+				int n = 0;
+				foreach (JoinRun<K,V> run in runs) {
+					JoinEntries<K,V>? entries = run.parts[index];
+					if (entries != null) n += entries.size;
+				}
+				keys = new K[n];
+				values = new V[n];
+				hashes = new uint[n];
+				next_same = new int[n];
+				heads = new int[n];
+				_next_head = new int[n];
+				int capacity = 2;
+				while (capacity < n) capacity <<= 1;
+				_buckets = new int[capacity];
+				for (int b = 0; b < capacity; b++) _buckets[b] = -1;
+				_shift = shift;
+
+				int[] tails = new int[n];
+				int e = 0;
+				foreach (JoinRun<K,V> run in runs) {
+					JoinEntries<K,V>? entries = run.parts[index];
+					if (entries == null) continue;
+					for (int i = 0; i < entries.size; i++, e++) {
+						uint h = entries.hashes[i];
+						keys[e] = (owned) entries.keys[i];
+						values[e] = (owned) entries.values[i];
+						hashes[e] = h;
+						next_same[e] = -1;
+						int head = find(keys[e], h, equal);
+						if (head < 0) {
+							int b = bucket_of(h);
+							_next_head[e] = _buckets[b];
+							_buckets[b] = e;
+							heads[num_heads++] = e;
+							tails[e] = e;
+						} else {
+							next_same[tails[head]] = e;
+							tails[head] = e;
+						}
+					}
+					run.parts[index] = null; // no longer needed
+				}
+			}
+
+			public int find (K key, uint hash, EqualDataFunc<K> equal) {
+				for (int e = _buckets[bucket_of(hash)]; e >= 0; e = _next_head[e]) {
+					if (hashes[e] == hash && equal(keys[e], key)) return e;
+				}
+				return -1;
+			}
+
+			private inline int bucket_of (uint hash) {
+				return (int) ((hash >> _shift) & (_buckets.length - 1));
+			}
+		}
+	}
+
+	/**
+	 * The entries of a partition gathered by a leaf.
+	 */
+	internal class JoinEntries<K,V> : Object {
+		public K[] keys;
+		public V[] values;
+		public uint[] hashes;
+		public int size;
+
+		public JoinEntries () {
+			keys = new K[8];
+			values = new V[8];
+			hashes = new uint[8];
+		}
+
+		public void add (uint hash, owned K key, V value) {
+			if (size == keys.length) {
+				int len = size * 2;
+				keys.resize(len);
+				values.resize(len);
+				hashes.resize(len);
+			}
+			keys[size] = (owned) key;
+			values[size] = value;
+			hashes[size] = hash;
+			size++;
+		}
+	}
+
+	/**
+	 * The entries gathered by a leaf, one per partition.
+	 */
+	internal class JoinRun<K,V> : Object {
+		public JoinEntries<K,V>?[] parts;
+
+		public JoinRun (int partitions) {
+			parts = new JoinEntries<K,V>?[partitions];
+		}
+
+		public void add (int partition, uint hash, owned K key, V value) {
+			JoinEntries<K,V>? entries = parts[partition];
+			if (entries == null) {
+				entries = new JoinEntries<K,V>();
+				parts[partition] = entries;
+			}
+			entries.add(hash, (owned) key, value);
+		}
+	}
+}
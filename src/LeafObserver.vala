@@ -0,0 +1,39 @@
+/* LeafObserver.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * An object that is notified of the computation time of fork-join leaf
+	 * tasks.
+	 *
+	 * {@link SpliteratorTask} notifies its executor of its leaf computations
+	 * if the executor implements this interface.
+	 */
+	internal interface LeafObserver : Object {
+		/**
+		 * Called after a leaf task has been computed.
+		 *
+		 * @param elements the estimated number of the elements of the leaf,
+		 * or a negative value if unknown
+		 * @param elapsed the elapsed time in microseconds
+		 */
+		public abstract void leaf_computed (int64 elements, int64 elapsed);
+	}
+}
@@ -72,5 +72,13 @@ namespace Gpseq {
 				return true;
 			}
 		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return SpliteratorCharacteristics.ORDERED
+					| SpliteratorCharacteristics.SIZED
+					| SpliteratorCharacteristics.SUBSIZED;
+			}
+		}
 	}
 }
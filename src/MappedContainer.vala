@@ -25,7 +25,7 @@ namespace Gpseq {
 	 * A container which contains the results of applying a mapper function to
 	 * the elements of a input.
 	 */
-	internal class MappedContainer<R,G> : Object, Spliterator<R>, Container<R,G> {
+	internal class MappedContainer<R,G> : Object, Spliterator<R>, Container<R,G>, SplitHint {
 		private Spliterator<G> _spliterator; // may be a Container
 		private Container<G,void*>? _parent;
 		private MapFunc<R,G> _mapper;
@@ -82,6 +82,20 @@ namespace Gpseq {
 			}
 		}
 
+		public bool is_oversized {
+			get {
+				return SplitHint.of<G>(_spliterator);
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				// the mapper may break the order and the distinctness
+				return _spliterator.characteristics
+					& ~(SpliteratorCharacteristics.SORTED | SpliteratorCharacteristics.DISTINCT);
+			}
+		}
+
 		public void each (Func<R> f) throws Error {
 			_spliterator.each(g => {
 				f(_mapper(g));
@@ -0,0 +1,98 @@
+/* Parker.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A permit-based parker for a single thread.
+	 *
+	 * {@link park} blocks the owner thread until {@link unpark} is called. If
+	 * unpark() has been called before park(), park() returns immediately and
+	 * consumes the permit. The fast paths are lock-free; the mutex is only
+	 * taken when the owner thread actually sleeps.
+	 */
+	internal class Parker {
+		private const int EMPTY = 0;
+		private const int PARKED = -1;
+		private const int NOTIFIED = 1;
+
+		private int _state; // AtomicInt
+		private Mutex _mutex;
+		private Cond _cond;
+
+		public Parker () {
+			_mutex = Mutex();
+			_cond = Cond();
+		}
+
+		/**
+		 * Blocks the current thread until either unpark() is called or
+		 * //end_time// has passed.
+		 *
+		 * Note. Called by the owner thread only.
+		 *
+		 * @param end_time the monotonic time to wait until
+		 * @return true if unparked, false if timed out
+		 */
+		public bool park_until (int64 end_time) {
+			if ( AtomicInt.compare_and_exchange(ref _state, NOTIFIED, EMPTY) ) {
+				return true;
+			}
+			_mutex.lock();
+			if ( !AtomicInt.compare_and_exchange(ref _state, EMPTY, PARKED) ) {
+				// NOTIFIED
+				AtomicInt.set(ref _state, EMPTY);
+				_mutex.unlock();
+				return true;
+			}
+			bool notified = false;
+			while (true) {
+				if ( AtomicInt.compare_and_exchange(ref _state, NOTIFIED, EMPTY) ) {
+					notified = true;
+					break;
+				}
+				if ( !_cond.wait_until(_mutex, end_time) ) {
+					// timed out; an unpark() may still have raced with us
+					notified = !AtomicInt.compare_and_exchange(ref _state, PARKED, EMPTY);
+					if (notified) AtomicInt.set(ref _state, EMPTY);
+					break;
+				}
+			}
+			_mutex.unlock();
+			return notified;
+		}
+
+		/**
+		 * Makes the permit available, and wakes the owner thread up if it is
+		 * parked.
+		 */
+		public void unpark () {
+			int old;
+			do {
+				old = AtomicInt.get(ref _state);
+				if (old == NOTIFIED) return;
+			} while ( !AtomicInt.compare_and_exchange(ref _state, old, NOTIFIED) );
+			if (old == PARKED) {
+				_mutex.lock();
+				_cond.signal();
+				_mutex.unlock();
+			}
+		}
+	}
+}
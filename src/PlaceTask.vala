@@ -0,0 +1,128 @@
+/* PlaceTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+namespace Gpseq {
+	/**
+	 * A fork-join task that stores the elements of an exactly sized
+	 * spliterator into an array, each at its encounter index.
+	 *
+	 * The spliterator must be {@link SpliteratorCharacteristics.SIZED} and
+	 * {@link SpliteratorCharacteristics.SUBSIZED}, so that the offset of
+	 * each leaf is known when it is split and the leaves store their
+	 * elements directly into the array, without intermediate buffers. If a
+	 * leaf does not have exactly as many elements as its size, the task
+	 * fails with {@link SpliteratorError.SIZE_MISMATCH} instead of storing
+	 * out of its range.
+	 */
+	internal class PlaceTask<G> : SpliteratorTask<void*,G> {
+		private SubArray<G> _dest;
+		private int _offset;
+		private int _size;
+
+		/**
+		 * Creates a new place task.
+		 *
+		 * @param dest the destination array
+		 * @param offset the index of the destination where the first
+		 * element is stored
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public PlaceTask (SubArray<G> dest, int offset,
+				Spliterator<G> spliterator, PlaceTask<G>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(spliterator, parent, threshold, max_depth, executor);
+			_dest = dest;
+			_offset = offset;
+			_size = (int) spliterator.estimated_size;
+		}
+
+		protected override void* empty_result {
+			owned get {
+				return null;
+			}
+		}
+
+		protected override void* leaf_compute () throws Error {
+			place<G>(_dest, _offset, _size, spliterator);
+			return null;
+		}
+
+		/**
+		 * Stores the elements of the given spliterator into the given range
+		 * of the array.
+		 *
+		 * Nothing is stored out of the range, even if the spliterator breaks
+		 * its exact size.
+		 *
+		 * @param dest the destination array
+		 * @param offset the start index of the range
+		 * @param size the size of the range, which is the exact size of the
+		 * spliterator
+		 * @param spliterator a spliterator
+		 * @throws SpliteratorError.SIZE_MISMATCH if the spliterator has more
+		 * or less elements than //size//, or the range is out of the array
+		 * @throws Error an error thrown while traversing the spliterator
+		 */
+		public static void place<A> (SubArray<A> dest, int offset, int size,
+				Spliterator<A> spliterator) throws Error {
+			if (offset < 0 || size < 0 || size > dest.size - offset) {
+				throw new SpliteratorError.SIZE_MISMATCH("Exact size out of the array");
+			}
+			int index = offset;
+			int end = offset + size;
+			bool overflowed = false;
+			spliterator.each_chunk(chunk => {
+				if (chunk.length > end - index) {
+					overflowed = true;
+					return false;
+				}
+				for (int i = 0; i < chunk.length; i++) {
+					dest[index++] = chunk[i];
+				}
+				return true;
+			});
+			if (overflowed || index != end) {
+				throw new SpliteratorError.SIZE_MISMATCH("Exact size mismatch");
+			}
+		}
+
+		protected override void* merge_results (owned void* left, owned void* right) throws Error {
+			return null;
+		}
+
+		protected override SpliteratorTask<void*,G> make_child (Spliterator<G> spliterator) {
+			// the left child covers a prefix, and is created first
+			int offset = _offset;
+			if (left_child != null) offset += ((PlaceTask<G>) left_child)._size;
+			var task = new PlaceTask<G>(
+					_dest, offset, spliterator,
+					this, threshold, max_depth, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
@@ -59,93 +59,100 @@ namespace Gpseq {
 			_future.set_exception((owned) exception);
 		}
 
+		/*
+		 * The completion state is an atomic state word, so ready checks and
+		 * completions are single atomic operations. Threads that wait for
+		 * the result park on the condition only if the future is not ready,
+		 * and completions signal it only if there are parked threads.
+		 * Callbacks are pushed onto a lock-free stack, which is closed when
+		 * the future completes.
+		 */
 		private class Future<G> : Gpseq.Future<G> {
+			private const int INIT = 0;
+			private const int COMPLETING = 1;
+			private const int READY = 2;
+			private const int EXCEPTION = 3;
+			private const size_t CLOSED = 1; // the callback stack has been closed
+
+			private int _state;
+			private int _waiters;
 			private Mutex _mutex;
 			private Cond _cond;
-			private State _state;
 			private G? _value;
 			private Error? _exception;
-			private CallbackFuncObject[]? _callbacks;
+			private void* _callbacks; // a CallbackNode* stack, or CLOSED
 
 			public Future () {
 				_mutex = Mutex();
 				_cond = Cond();
-				_state = State.INIT;
-				_callbacks = new CallbackFuncObject[0];
+				_state = INIT;
+			}
+
+			~Future () {
+				if ((size_t) _callbacks != CLOSED) {
+					free_nodes((CallbackNode*) _callbacks);
+				}
 			}
 
 			public override bool ready {
 				get {
-					_mutex.lock();
-					bool result = _state != State.INIT;
-					_mutex.unlock();
-					return result;
+					return AtomicInt.get(ref _state) >= READY;
 				}
 			}
 
 			public override unowned G wait () throws Error {
-				_mutex.lock();
-				switch (_state) {
-				case State.READY:
-					unowned G result = _value;
-					_mutex.unlock();
-					return result;
-				case State.EXCEPTION:
+				if (AtomicInt.get(ref _state) < READY) {
+					park(-1);
+				}
+				if (AtomicInt.get(ref _state) == EXCEPTION) {
 					unowned Error result = _exception;
-					_mutex.unlock();
 					throw result;
-				case State.INIT:
-					while (_state == State.INIT) {
-						_cond.wait(_mutex);
-					}
-					_mutex.unlock();
-					return wait();
-				default:
-					assert_not_reached();
 				}
+				return _value;
 			}
 
 			public override bool wait_until (int64 end_time, out unowned G? value = null) throws Error {
-				_mutex.lock();
-				switch (_state) {
-				case State.READY:
-					value = _value;
-					_mutex.unlock();
-					return true;
-				case State.EXCEPTION:
+				if (AtomicInt.get(ref _state) < READY && !park(end_time)) {
+					value = null;
+					return false;
+				}
+				if (AtomicInt.get(ref _state) == EXCEPTION) {
 					value = null;
 					unowned Error result = _exception;
-					_mutex.unlock();
 					throw result;
-				case State.INIT:
-					while (_state == State.INIT) {
-						if ( !_cond.wait_until(_mutex, end_time) ) {
-							value = null;
-							_mutex.unlock();
-							return false;
-						}
-					}
-					_mutex.unlock();
-					return wait_until(end_time, out value);
-				default:
-					assert_not_reached();
 				}
+				value = _value;
+				return true;
 			}
 
-			public override Result<A> transform<A> (owned Result.TransformFunc<A,G> func) {
+			/**
+			 * Blocks until this future is ready or the end time is reached.
+			 *
+			 * @param end_time the monotonic time to wait until, or a negative
+			 * value to wait without timeout
+			 * @return true if this future is ready
+			 */
+			private bool park (int64 end_time) {
+				AtomicInt.inc(ref _waiters);
 				_mutex.lock();
-				switch (_state) {
-				case State.READY:
-				case State.EXCEPTION:
-					_mutex.unlock();
-					Result<A> result = func(this);
-					if ( !(result is Future) ) {
-						result = Gpseq.Future.done<A>(result);
+				bool result = true;
+				while (AtomicInt.get(ref _state) < READY) {
+					if (end_time < 0) {
+						_cond.wait(_mutex);
+					} else if ( !_cond.wait_until(_mutex, end_time) ) {
+						result = AtomicInt.get(ref _state) >= READY;
+						break;
 					}
-					return result;
-				case State.INIT:
+				}
+				_mutex.unlock();
+				AtomicInt.add(ref _waiters, -1);
+				return result;
+			}
+
+			public override Result<A> transform<A> (owned Result.TransformFunc<A,G> func) {
+				if (AtomicInt.get(ref _state) < READY) {
 					var promise = new Promise<A>();
-					_callbacks += CallbackFuncObject(() => {
+					CallbackNode* node = new CallbackNode(() => {
 						Result<A> result = func(this);
 						if ( !(result is Future) ) {
 							result = Gpseq.Future.done<A>(result);
@@ -158,51 +165,96 @@ namespace Gpseq {
 							}
 						});
 					});
-					_mutex.unlock();
-					return promise.future;
-				default:
-					assert_not_reached();
+					if ( push_callback(node) ) {
+						return promise.future;
+					}
+					// completed in the meantime
+					delete node;
+				}
+				Result<A> result = func(this);
+				if ( !(result is Future) ) {
+					result = Gpseq.Future.done<A>(result);
+				}
+				return result;
+			}
+
+			/**
+			 * Pushes the callback node onto the stack.
+			 *
+			 * @return true if pushed, or false if this future has completed
+			 */
+			private bool push_callback (CallbackNode* node) {
+				while (true) {
+					void* head = AtomicPointer.get(&_callbacks);
+					if ((size_t) head == CLOSED) return false;
+					node->next = (CallbackNode*) head;
+					if ( AtomicPointer.compare_and_exchange(&_callbacks, head, node) ) {
+						return true;
+					}
 				}
 			}
 
 			public void set_value (owned G value) {
-				_mutex.lock();
-				assert(_state == State.INIT);
-				_state = State.READY;
+				bool claimed = AtomicInt.compare_and_exchange(ref _state, INIT, COMPLETING);
+				assert(claimed);
 				_value = (owned) value;
-				CallbackFuncObject[] callbacks = (owned) _callbacks;
-				_cond.broadcast();
-				_mutex.unlock();
-				for (int i = 0; i < callbacks.length; i++) {
-					callbacks[i].func();
-				}
+				complete(READY);
 			}
 
 			public void set_exception (owned Error exception) {
-				_mutex.lock();
-				assert(_state == State.INIT);
-				_state = State.EXCEPTION;
+				bool claimed = AtomicInt.compare_and_exchange(ref _state, INIT, COMPLETING);
+				assert(claimed);
 				_exception = (owned) exception;
-				CallbackFuncObject[] callbacks = (owned) _callbacks;
-				_cond.broadcast();
-				_mutex.unlock();
-				for (int i = 0; i < callbacks.length; i++) {
-					callbacks[i].func();
+				complete(EXCEPTION);
+			}
+
+			private void complete (int state) {
+				AtomicInt.set(ref _state, state);
+				if (AtomicInt.get(ref _waiters) > 0) {
+					_mutex.lock();
+					_cond.broadcast();
+					_mutex.unlock();
+				}
+
+				void* head;
+				do {
+					head = AtomicPointer.get(&_callbacks);
+				} while ( !AtomicPointer.compare_and_exchange(&_callbacks, head, (void*) CLOSED) );
+
+				// the stack is in reverse order of registration
+				CallbackNode* reversed = null;
+				CallbackNode* node = (CallbackNode*) head;
+				while (node != null) {
+					CallbackNode* next = node->next;
+					node->next = reversed;
+					reversed = node;
+					node = next;
+				}
+				node = reversed;
+				while (node != null) {
+					CallbackNode* next = node->next;
+					node->func();
+					delete node;
+					node = next;
 				}
 			}
 
-			private enum State {
-				INIT,
-				READY,
-				EXCEPTION
+			private static void free_nodes (CallbackNode* node) {
+				while (node != null) {
+					CallbackNode* next = node->next;
+					delete node;
+					node = next;
+				}
 			}
 
 			private delegate void CallbackFunc ();
 
-			private struct CallbackFuncObject {
+			[Compact]
+			private class CallbackNode {
 				public CallbackFunc func;
+				public CallbackNode* next;
 
-				public CallbackFuncObject (owned CallbackFunc func) {
+				public CallbackNode (owned CallbackFunc func) {
 					this.func = (owned) func;
 				}
 			}
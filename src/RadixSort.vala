@@ -0,0 +1,296 @@
+/* RadixSort.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A parallel LSD radix sort of 64-bit keys.
+	 *
+	 * The keys are sorted a byte at a time, from the least significant byte.
+	 * Each pass splits the array into blocks; every block counts its digits,
+	 * the counts are turned into per-block output offsets, and then every
+	 * block scatters its keys to the offsets. The scatter is stable, so the
+	 * passes compose. A pass is skipped if all keys have the same digit.
+	 *
+	 * Keys are int64 or double values sorted in place, or int64 keys
+	 * extracted from the elements of a gpointer array, in which case the
+	 * elements are permuted by the sorted keys at the end.
+	 */
+	internal class RadixSort : Object {
+		private const int RADIX = 256;
+		private const int DIGITS = 8;
+		private const int MIN_BLOCK_SIZE = 4096;
+		private const uint64 SIGN = (uint64) 1 << 63;
+
+		private Mode _mode;
+		private uint64* _target; // the array to sort, if not keyed
+		private uint64* _keys; // the current keys; may be the array to sort
+		private uint64* _keys_alt; // the scatter destination
+		private int* _perm;
+		private int* _perm_alt;
+		private uint64[]? _key_buf;
+		private uint64[]? _key_buf2;
+		private int[]? _perm_buf;
+		private int[]? _perm_buf2;
+		private void** _elements;
+		private KeyFunc<void*>? _key_func;
+
+		private int _length;
+		private int _num_blocks;
+		private int _block_size;
+		private int[] _counts; // [block * RADIX + digit]
+
+		/**
+		 * Creates a radix sort of the given int64 array.
+		 */
+		public RadixSort.for_int64 (int64* array, int length, int parallels) {
+			this(Mode.INT64, length, parallels);
+			_target = (uint64*) array;
+			_keys = _target;
+			_key_buf2 = new uint64[length];
+			_keys_alt = (uint64*) _key_buf2;
+		}
+
+		/**
+		 * Creates a radix sort of the given double array.
+		 */
+		public RadixSort.for_double (double* array, int length, int parallels) {
+			this(Mode.DOUBLE, length, parallels);
+			_target = (uint64*) array;
+			_keys = _target;
+			_key_buf2 = new uint64[length];
+			_keys_alt = (uint64*) _key_buf2;
+		}
+
+		/**
+		 * Creates a radix sort of the given gpointer array, by the keys
+		 * extracted by the given function.
+		 */
+		public RadixSort.keyed (void** array, int length, owned KeyFunc<void*> key_func, int parallels) {
+			this(Mode.KEYED, length, parallels);
+			_elements = array;
+			_key_func = (owned) key_func;
+			_key_buf = new uint64[length];
+			_key_buf2 = new uint64[length];
+			_perm_buf = new int[length];
+			_perm_buf2 = new int[length];
+			_keys = (uint64*) _key_buf;
+			_keys_alt = (uint64*) _key_buf2;
+			_perm = (int*) _perm_buf;
+			_perm_alt = (int*) _perm_buf2;
+		}
+
+		private RadixSort (Mode mode, int length, int parallels) {
+			_mode = mode;
+			_length = length;
+			int max_blocks = int.max(length / MIN_BLOCK_SIZE, 1);
+			_num_blocks = int.min(int.max(parallels, 1) * 4, max_blocks);
+			_block_size = (length + _num_blocks - 1) / _num_blocks;
+			if (_block_size == 0) _block_size = 1;
+			_counts = new int[_num_blocks * RADIX];
+		}
+
+		/**
+		 * Sorts the array.
+		 *
+		 * @param executor an executor to run blocks in parallel, or null to
+		 * run all blocks in the current thread
+		 */
+		public void sort (Executor? executor) throws Error {
+			if (_mode == Mode.KEYED) {
+				run_pass(Pass.KEYS, 0, executor);
+			}
+			for (int d = 0; d < DIGITS; d++) {
+				int shift = d * 8;
+				run_pass(Pass.COUNT, shift, executor);
+				if ( !compute_offsets() ) continue; // all keys have the same digit
+				run_pass(Pass.SCATTER, shift, executor);
+				swap_buffers();
+			}
+			if (_mode == Mode.KEYED) {
+				// gather the elements into the spare key buffer, by the
+				// sorted permutation, then copy them back
+				run_pass(Pass.GATHER, 0, executor);
+				Memory.copy(_elements, _keys_alt, sizeof(void*) * _length);
+			} else if (_keys != _target) {
+				// the sorted keys are in the temporary buffer
+				Memory.copy(_target, _keys, sizeof(uint64) * _length);
+			}
+		}
+
+		private void run_pass (Pass pass, int shift, Executor? executor) throws Error {
+			if (executor == null || _num_blocks == 1) {
+				for (int b = 0; b < _num_blocks; b++) {
+					run_block(pass, shift, b);
+				}
+			} else {
+				var task = new PassTask(this, pass, shift,
+						0, _num_blocks, null, 1, -1, (!)executor);
+				task.invoke();
+			}
+		}
+
+		private void swap_buffers () {
+			uint64* k = _keys;
+			_keys = _keys_alt;
+			_keys_alt = k;
+			int* p = _perm;
+			_perm = _perm_alt;
+			_perm_alt = p;
+		}
+
+		/**
+		 * Turns the digit counts into output offsets, digit-major and
+		 * block-minor.
+		 *
+		 * @return false if all keys have the same digit, i.e. the pass can be
+		 * skipped
+		 */
+		private bool compute_offsets () {
+			int offset = 0;
+			for (int digit = 0; digit < RADIX; digit++) {
+				int total = 0;
+				for (int b = 0; b < _num_blocks; b++) {
+					total += _counts[b * RADIX + digit];
+				}
+				if (total == _length) return false;
+				for (int b = 0; b < _num_blocks; b++) {
+					int idx = b * RADIX + digit;
+					int count = _counts[idx];
+					_counts[idx] = offset;
+					offset += count;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * Maps a raw key to an unsigned key with the same order.
+		 */
+		private inline uint64 order_key (uint64 raw) {
+			switch (_mode) {
+			case Mode.DOUBLE:
+				// negative: flip all bits; positive: flip the sign bit
+				return raw ^ ((uint64) ((int64) raw >> 63) | SIGN);
+			case Mode.INT64:
+				return raw ^ SIGN;
+			default:
+				return raw; // already mapped by Pass.KEYS
+			}
+		}
+
+		internal void run_block (Pass pass, int shift, int block) {
+			int start = block * _block_size;
+			int end = int.min(start + _block_size, _length);
+			switch (pass) {
+			case Pass.KEYS:
+				for (int i = start; i < end; i++) {
+					_keys[i] = (uint64) _key_func(_elements[i]) ^ SIGN;
+					_perm[i] = i;
+				}
+				break;
+			case Pass.COUNT:
+				int* counts = (int*) _counts + block * RADIX;
+				for (int i = 0; i < RADIX; i++) {
+					counts[i] = 0;
+				}
+				for (int i = start; i < end; i++) {
+					counts[(int) ((order_key(_keys[i]) >> shift) & 0xff)]++;
+				}
+				break;
+			case Pass.SCATTER:
+				int* offsets = (int*) _counts + block * RADIX;
+				if (_perm == null) {
+					for (int i = start; i < end; i++) {
+						uint64 k = _keys[i];
+						int pos = offsets[(int) ((order_key(k) >> shift) & 0xff)]++;
+						_keys_alt[pos] = k;
+					}
+				} else {
+					for (int i = start; i < end; i++) {
+						uint64 k = _keys[i];
+						int pos = offsets[(int) ((k >> shift) & 0xff)]++;
+						_keys_alt[pos] = k;
+						_perm_alt[pos] = _perm[i];
+					}
+				}
+				break;
+			case Pass.GATHER:
+				void** dest = (void**) _keys_alt;
+				for (int i = start; i < end; i++) {
+					dest[i] = _elements[_perm[i]];
+				}
+				break;
+			default:
+				assert_not_reached();
+			}
+		}
+
+		private enum Mode {
+			INT64,
+			DOUBLE,
+			KEYED
+		}
+
+		internal enum Pass {
+			KEYS,
+			COUNT,
+			SCATTER,
+			GATHER
+		}
+
+		/**
+		 * Runs a pass over a range of blocks.
+		 */
+		private class PassTask : RangeTask<void*> {
+			private RadixSort _sort;
+			private Pass _pass;
+			private int _shift;
+
+			public PassTask (RadixSort sort, Pass pass, int shift,
+					int start, int end, PassTask? parent,
+					int64 threshold, int max_depth, Executor executor)
+			{
+				base(start, end, parent, threshold, max_depth, executor);
+				_sort = sort;
+				_pass = pass;
+				_shift = shift;
+			}
+
+			protected override void* leaf_compute (int start, int end) throws Error {
+				for (int b = start; b < end; b++) {
+					_sort.run_block(_pass, _shift, b);
+				}
+				return null;
+			}
+
+			protected override void* merge_results (owned void* left, owned void* right) {
+				return null;
+			}
+
+			protected override RangeTask<void*> make_child (int start, int end) {
+				var task = new PassTask(_sort, _pass, _shift,
+						start, end, this,
+						threshold, max_depth, executor);
+				task.depth = depth + 1;
+				return task;
+			}
+		}
+	}
+}
@@ -0,0 +1,121 @@
+/* RangeSpliterator.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A spliterator of an arithmetic progression of integers.
+	 *
+	 * The elements are generated on demand, and the spliterator is split
+	 * arithmetically; nothing is materialized.
+	 */
+	internal class RangeSpliterator : Object, Spliterator<int> {
+		private int64 _next; // the next element
+		private int64 _remaining; // the number of the remaining elements
+		private int _step;
+
+		/**
+		 * Creates a new range spliterator.
+		 *
+		 * @param start the first element
+		 * @param end the bound of the elements, exclusive
+		 * @param step the difference between two consecutive elements. must
+		 * not be zero
+		 */
+		public RangeSpliterator (int start, int end, int step) {
+			_next = start;
+			_remaining = count_of(start, end, step);
+			_step = step;
+		}
+
+		private RangeSpliterator.with_count (int64 start, int64 count, int step) {
+			_next = start;
+			_remaining = count;
+			_step = step;
+		}
+
+		/**
+		 * Returns the number of the elements in [start, end) with the given
+		 * step.
+		 */
+		public static int64 count_of (int start, int end, int step)
+			requires (step != 0)
+		{
+			int64 span = (int64) end - start;
+			if (step > 0) {
+				return span <= 0 ? 0 : (span + step - 1) / step;
+			} else {
+				return span >= 0 ? 0 : (span + step + 1) / step;
+			}
+		}
+
+		public Spliterator<int>? try_split () {
+			if (_remaining < 2) return null;
+			int64 half = _remaining >> 1;
+			var prefix = new RangeSpliterator.with_count(_next, half, _step);
+			_next += half * _step;
+			_remaining -= half;
+			return prefix;
+		}
+
+		public bool try_advance (Func<int> consumer) throws Error {
+			if (_remaining > 0) {
+				int item = (int) _next;
+				_next += _step;
+				_remaining--;
+				consumer(item);
+				return true;
+			} else {
+				return false;
+			}
+		}
+
+		public void each (Func<int> f) throws Error {
+			while (_remaining > 0) {
+				int item = (int) _next;
+				_next += _step;
+				_remaining--;
+				f(item);
+			}
+		}
+
+		public int64 estimated_size {
+			get {
+				return _remaining;
+			}
+		}
+
+		public bool is_size_known {
+			get {
+				return true;
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				var c = SpliteratorCharacteristics.ORDERED
+					| SpliteratorCharacteristics.DISTINCT
+					| SpliteratorCharacteristics.SIZED
+					| SpliteratorCharacteristics.SUBSIZED;
+				if (_step > 0) c |= SpliteratorCharacteristics.SORTED;
+				return c;
+			}
+		}
+	}
+}
@@ -0,0 +1,137 @@
+/* RangeTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A base class for fork-join tasks over a range of array indices.
+	 *
+	 * A range is split in half until it is not longer than the threshold or
+	 * the max depth is reached.
+	 *
+	 * Once a leaf throws an error, the task tree is cancelled: the leaves
+	 * that have not started yet are skipped, and the root task is completed
+	 * with the first error.
+	 */
+	internal abstract class RangeTask<R> : ForkJoinTask<R> {
+		private int _start;
+		private int _end;
+		private unowned RangeTask<R> _root;
+		private Error? _first_error; // the first error thrown by a leaf; only set on the root
+
+		/**
+		 * Creates a range task.
+		 *
+		 * @param start zero-based index of the begin
+		 * @param end zero-based index after the end
+		 * @param parent the parent of this task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		protected RangeTask (int start, int end, RangeTask<R>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(parent, threshold, max_depth, executor);
+			_start = start;
+			_end = end;
+			_root = parent == null ? this : parent._root;
+		}
+
+		protected override void compute () {
+			if (is_cancelled) {
+				// another leaf has failed
+				return_error(_root.first_error());
+				return;
+			}
+
+			int len = _end - _start;
+			if (len <= threshold || 0 <= max_depth <= depth) {
+				try {
+					return_value( leaf_compute(_start, _end) );
+				} catch (Error err) {
+					_root.fail(err);
+					return_error(_root.first_error());
+				}
+				return;
+			}
+
+			int mid = _start + (len >> 1);
+			RangeTask<R> left = make_child(_start, mid);
+			RangeTask<R> right = make_child(mid, _end);
+			left.fork();
+			try {
+				right.invoke();
+				R result_r = right.join();
+				R result_l = left.join();
+				return_value( merge_results((owned) result_l, (owned) result_r) );
+			} catch (Error err) {
+				// the tree has been cancelled, but the forked child may still
+				// be running. it must finish before this task completes,
+				// since it reaches its ancestors and the state they own
+				try {
+					left.join();
+				} catch (Error left_err) {
+					// the first error is already known
+				}
+				return_error((owned) err);
+			}
+		}
+
+		/**
+		 * Records the given error if it is the first one, and cancels the
+		 * task tree. Called on the root task.
+		 */
+		private void fail (Error err) {
+			lock (_first_error) {
+				if (_first_error == null) _first_error = err.copy();
+			}
+			cancel();
+		}
+
+		private Error first_error () {
+			Error err;
+			lock (_first_error) {
+				err = _first_error.copy();
+			}
+			return err;
+		}
+
+		/**
+		 * Computes the given range sequentially.
+		 *
+		 * @param start zero-based index of the begin
+		 * @param end zero-based index after the end
+		 * @throws Error an error that fails the whole task tree
+		 */
+		protected abstract R leaf_compute (int start, int end) throws Error;
+
+		/**
+		 * Merges the left and right result, then returns the merged result.
+		 */
+		protected abstract R merge_results (owned R left, owned R right);
+
+		/**
+		 * Creates a child task with the given range.
+		 *
+		 * The depth of the child must be set to //depth + 1//.
+		 */
+		protected abstract RangeTask<R> make_child (int start, int end);
+	}
+}
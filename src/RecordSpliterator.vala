@@ -0,0 +1,177 @@
+/* RecordSpliterator.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A function that creates a record from a region of bytes.
+	 *
+	 * @param bytes the whole bytes
+	 * @param offset the offset of the record, in bytes
+	 * @param length the length of the record, in bytes, excluding the
+	 * delimiter
+	 * @return the record
+	 */
+	internal delegate G RecordFunc<G> (Bytes bytes, size_t offset, size_t length);
+
+	/**
+	 * A spliterator of the delimiter-separated records of bytes, such as the
+	 * lines of a mapped file.
+	 *
+	 * A spliterator covers a region of bytes which starts at the beginning of
+	 * a record and ends at the end of a record. It is split at the middle of
+	 * the region, resynchronized to the next record boundary, so partitions
+	 * cover disjoint regions and are traversed without copying the bytes.
+	 *
+	 * The estimated size is the number of the remaining bytes divided by the
+	 * average record length in a prefix of the bytes.
+	 */
+	internal class RecordSpliterator<G> : Object, Spliterator<G> {
+		private Records<G> _records;
+		private size_t _pos; // the beginning of the next record
+		private size_t _end; // the end of the region
+
+		/**
+		 * Creates a new record spliterator which covers all the records.
+		 *
+		 * @param bytes the bytes
+		 * @param delimiter the record delimiter
+		 * @param func a function that creates records
+		 */
+		public RecordSpliterator (Bytes bytes, uint8 delimiter, owned RecordFunc<G> func) {
+			_records = new Records<G>(bytes, delimiter, (owned) func);
+			_pos = 0;
+			_end = bytes.get_size();
+		}
+
+		private RecordSpliterator.region (Records<G> records, size_t start, size_t end) {
+			_records = records;
+			_pos = start;
+			_end = end;
+		}
+
+		public Spliterator<G>? try_split () {
+			size_t mid = _pos + ((_end - _pos) >> 1);
+			if (mid <= _pos) return null;
+			// a record belongs to the region that contains its first byte
+			size_t boundary = _records.find(mid, _end) + 1; // after the delimiter
+			if (boundary >= _end) return null;
+			var result = new RecordSpliterator<G>.region(_records, _pos, boundary);
+			_pos = boundary;
+			return result;
+		}
+
+		public bool try_advance (Func<G> consumer) throws Error {
+			if (_pos >= _end) return false;
+			consumer( next() );
+			return true;
+		}
+
+		public int64 estimated_size {
+			get {
+				if (_pos >= _end) return 0;
+				size_t avg = _records.average_length;
+				return (int64) ((_end - _pos + avg - 1) / avg);
+			}
+		}
+
+		public bool is_size_known {
+			get {
+				return false;
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return SpliteratorCharacteristics.ORDERED;
+			}
+		}
+
+		public void each (Func<G> f) throws Error {
+			while (_pos < _end) {
+				f( next() );
+			}
+		}
+
+		private G next () {
+			size_t start = _pos;
+			size_t stop = _records.find(start, _end);
+			_pos = stop < _end ? stop + 1 : _end;
+			return _records.make(start, stop - start);
+		}
+
+		/**
+		 * The bytes and the record function, shared by all the partitions.
+		 */
+		private class Records<G> : Object {
+			private const size_t SAMPLE_SIZE = 64 * 1024;
+
+			private Bytes _bytes;
+			private uint8* _data;
+			private uint8 _delimiter;
+			private RecordFunc<G> _func;
+			private size_t _average_length;
+
+			public Records (Bytes bytes, uint8 delimiter, owned RecordFunc<G> func) {
+				_bytes = bytes;
+				_data = bytes.get_size() > 0 ? (uint8*) bytes.get_data() : null;
+				_delimiter = delimiter;
+				_func = (owned) func;
+				_average_length = sample_average_length();
+			}
+
+			/**
+			 * The average length of the records in a prefix of the bytes,
+			 * including the delimiters. always >= 1.
+			 */
+			public size_t average_length {
+				get {
+					return _average_length;
+				}
+			}
+
+			private size_t sample_average_length () {
+				size_t len = _bytes.get_size();
+				if (len > SAMPLE_SIZE) len = SAMPLE_SIZE;
+				size_t count = 0;
+				for (size_t i = 0; i < len; i++) {
+					if (_data[i] == _delimiter) count++;
+				}
+				if (count == 0) return len > 0 ? len : 1;
+				return len / count; // count <= len
+			}
+
+			/**
+			 * Finds the first delimiter in the given range.
+			 *
+			 * @return the index of the delimiter, or //end// if not found
+			 */
+			public size_t find (size_t start, size_t end) {
+				for (size_t i = start; i < end; i++) {
+					if (_data[i] == _delimiter) return i;
+				}
+				return end;
+			}
+
+			public G make (size_t offset, size_t length) {
+				return _func(_bytes, offset, length);
+			}
+		}
+	}
+}
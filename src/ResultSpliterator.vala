@@ -89,6 +89,15 @@ namespace Gpseq {
 			}
 		}
 
+		public SpliteratorCharacteristics characteristics {
+			get {
+				if (_spliterator == null) {
+					return SpliteratorCharacteristics.SIZED | SpliteratorCharacteristics.SUBSIZED;
+				}
+				return _spliterator.characteristics;
+			}
+		}
+
 		public void each (Func<G> f) throws Error {
 			if (_spliterator == null) return;
 			check_traversal();
@@ -0,0 +1,151 @@
+/* ScanContainer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/*
+	 * A container which contains the running totals of the elements of a
+	 * input, in encounter order.
+	 */
+	internal class ScanContainer<G> : DefaultContainer<G> {
+		private const int MIN_BLOCK_SIZE = ARRAY_CHUNK_SIZE;
+		private const int BLOCKS_PER_THREAD = 4;
+
+		private CombineFunc<G>? _op;
+		private G _identity;
+
+		/**
+		 * Creates a new scan container.
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new container
+		 * @param op an associative, //non-interfering// and //stateless//
+		 * combine function
+		 * @param identity the identity value of //op//
+		 */
+		public ScanContainer (Spliterator<G> spliterator, Container<G,void*> parent,
+				owned CombineFunc<G> op, G identity) {
+			base(spliterator, parent, new Consumer<G>());
+			_op = (owned) op;
+			_identity = identity;
+
+			SpliteratorCharacteristics input = spliterator.characteristics;
+			SpliteratorCharacteristics c = SpliteratorCharacteristics.ORDERED;
+			if (SpliteratorCharacteristics.SIZED in input) {
+				// the input is stored in an array before traversal
+				c |= SpliteratorCharacteristics.SIZED | SpliteratorCharacteristics.SUBSIZED;
+			}
+			set_characteristics(c);
+		}
+
+		private ScanContainer.copy (ScanContainer<G> container, Spliterator<G> spliterator) {
+			base(spliterator, container.parent, container.consumer);
+		}
+
+		protected override DefaultContainer<G> make_container (Spliterator<G> spliterator) {
+			return new ScanContainer<G>.copy(this, spliterator);
+		}
+
+		public override Future<void*> start (Seq seq) {
+			var future = parent != null ? parent.start(seq) : Future.of<void*>(null);
+			set_parent(null);
+			return (Future<void*>) future.flat_map<void*>(value => {
+				try {
+					return scan(seq);
+				} catch (Error err) {
+					var promise = new Promise<void*>();
+					promise.set_exception((owned) err);
+					return promise.future;
+				}
+			});
+		}
+
+		/**
+		 * Computes the running totals in place.
+		 *
+		 * In parallel, the array is divided into blocks. The totals of the
+		 * blocks are computed in parallel, turned into the offsets of the
+		 * blocks sequentially, and then the blocks are rescanned in parallel
+		 * starting with their offsets.
+		 */
+		private Future<void*> scan (Seq seq) throws Error {
+			G[] array = spliter_to_array();
+			int len = array.length;
+			SubArray<G> sub = new SubArray<G>(array);
+			int blocks = seq.is_parallel ? num_blocks(len, seq.task_env) : 1;
+			int block_size = blocks > 1 ? (len + blocks - 1) / blocks : int.max(len, 1);
+			blocks = (len + block_size - 1) / block_size;
+			G[] sums = new G[blocks];
+			SubArray<G> sums_sub = new SubArray<G>(sums);
+			Executor executor = seq.task_env.executor;
+
+			if (blocks <= 1) {
+				if (len > 0) {
+					sums[0] = _identity;
+					var task = new ScanTask<G>(ScanTask.Phase.APPLY, sub, sums_sub, block_size,
+							_op, 0, 1, null, 1, executor);
+					task.invoke();
+				}
+				spliterator = new ArraySpliterator<G>((owned) array, 0, len);
+				return Future.of<void*>(null);
+			}
+
+			var reduce = new ScanTask<G>(ScanTask.Phase.REDUCE, sub, sums_sub, block_size,
+					_op, 0, blocks - 1, null, 1, executor);
+			reduce.fork();
+			return (Future<void*>) reduce.future.flat_map<void*>(value => {
+				try {
+					to_offsets(sums);
+				} catch (Error err) {
+					var promise = new Promise<void*>();
+					promise.set_exception((owned) err);
+					return promise.future;
+				}
+
+				var apply = new ScanTask<G>(ScanTask.Phase.APPLY, sub, sums_sub, block_size,
+						_op, 0, blocks, null, 1, executor);
+				apply.fork();
+				return apply.future.map<void*>(v => {
+					spliterator = new ArraySpliterator<G>((owned) array, 0, len);
+					sums = null;
+					return null;
+				});
+			});
+		}
+
+		/**
+		 * Turns the block totals into the block offsets. The total of the
+		 * last block is not used.
+		 */
+		private void to_offsets (G[] sums) throws Error {
+			G offset = _identity;
+			for (int b = 0; b < sums.length; b++) {
+				G total = (owned) sums[b];
+				sums[b] = offset;
+				if (b < sums.length - 1) offset = _op((owned) offset, (owned) total);
+			}
+		}
+
+		private int num_blocks (int len, TaskEnv env) {
+			int threads = env.executor.parallels;
+			if (threads <= 1 || env.resolve_threshold(len, threads) >= len) return 1;
+			int64 blocks = (int64) threads * BLOCKS_PER_THREAD;
+			return (int) int64.max(int64.min(blocks, len / MIN_BLOCK_SIZE), 1);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/* ScanTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A task for one pass of a two-pass parallel prefix scan.
+	 *
+	 * The array is divided into blocks of a fixed size, and the task range
+	 * is a range of block indices. The {@link Phase.REDUCE} pass stores the
+	 * total of each block in //sums//; after the totals have been turned
+	 * into the offsets of the blocks, the {@link Phase.APPLY} pass rescans
+	 * each block in place, starting with its offset.
+	 */
+	internal class ScanTask<G> : RangeTask<void*> {
+		internal enum Phase {
+			REDUCE,
+			APPLY
+		}
+
+		private Phase _phase;
+		private SubArray<G> _array;
+		private SubArray<G> _sums;
+		private int _block_size;
+		private unowned CombineFunc<G> _op;
+
+		/**
+		 * Creates a new scan task.
+		 *
+		 * @param phase the pass of this task
+		 * @param array the elements, which are replaced with the results by
+		 * the apply pass
+		 * @param sums the block totals or the block offsets, one per block
+		 * @param block_size the number of the elements per block
+		 * @param op an associative combine function
+		 * @param start the index of the first block
+		 * @param end the index after the last block
+		 * @param parent the parent of this task
+		 * @param threshold the number of the blocks computed sequentially
+		 * @param executor an executor that will invoke the task
+		 */
+		public ScanTask (Phase phase, SubArray<G> array, SubArray<G> sums, int block_size,
+				CombineFunc<G> op, int start, int end,
+				ScanTask<G>? parent, int64 threshold, Executor executor)
+		{
+			base(start, end, parent, threshold, -1, executor);
+			_phase = phase;
+			_array = array;
+			_sums = sums;
+			_block_size = block_size;
+			_op = op;
+		}
+
+		protected override void* leaf_compute (int start, int end) throws Error {
+			for (int b = start; b < end; b++) {
+				int lo = b * _block_size;
+				int hi = int.min(lo + _block_size, _array.size);
+				if (_phase == Phase.REDUCE) {
+					_sums[b] = reduce_block(lo, hi);
+				} else {
+					scan_block(lo, hi, _sums[b]);
+				}
+			}
+			return null;
+		}
+
+		private G reduce_block (int lo, int hi) throws Error {
+			G acc = _array[lo];
+			for (int i = lo + 1; i < hi; i++) {
+				acc = _op((owned) acc, _array[i]);
+			}
+			return (owned) acc;
+		}
+
+		private void scan_block (int lo, int hi, G offset) throws Error {
+			G acc = offset;
+			for (int i = lo; i < hi; i++) {
+				acc = _op((owned) acc, _array[i]);
+				_array[i] = acc;
+			}
+		}
+
+		protected override void* merge_results (owned void* left, owned void* right) {
+			return null;
+		}
+
+		protected override RangeTask<void*> make_child (int start, int end) {
+			var task = new ScanTask<G>(_phase, _array, _sums, _block_size, _op, start, end,
+					this, threshold, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
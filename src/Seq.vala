@@ -321,6 +321,93 @@ namespace Gpseq {
 			return Seq.of_iterator<G>(iter, -1, false, env);
 		}
 
+		/**
+		 * Creates a new sequential seq of the integers from //start//
+		 * (inclusive) to //end// (exclusive), incremented by //step//.
+		 *
+		 * The returned seq is similar to the for-loop below, but the
+		 * elements are generated on demand and the seq is split
+		 * arithmetically in constant time, so parallel executions are
+		 * partitioned as evenly as array-backed seqs.
+		 *
+		 * {{{
+		 * for (int i = start; step > 0 ? i < end : i > end; i += step) {
+		 *     // Operations on the i.
+		 * }
+		 * }}}
+		 *
+		 * @param start the first element
+		 * @param end the bound of the elements, exclusive
+		 * @param step the difference between two consecutive elements. must
+		 * not be zero
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public static Seq<int> range (int start, int end, int step = 1, TaskEnv? env = null)
+			requires (step != 0)
+		{
+			return new Seq<int>(new RangeSpliterator(start, end, step), env);
+		}
+
+		/**
+		 * Creates a new sequential seq of the records of the given file,
+		 * separated by the given delimiter.
+		 *
+		 * The file is mapped into memory, and each record is a slice of the
+		 * mapped bytes, without the delimiter; the records are not copied.
+		 * The seq is split at byte offsets, resynchronized to the next
+		 * delimiter, so parallel executions read disjoint regions of the file
+		 * concurrently.
+		 *
+		 * The file must not be modified until the execution of the seq
+		 * pipeline is completed, and while the records are used.
+		 *
+		 * @param path the path of the file
+		 * @param delimiter the record delimiter
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 * @throws FileError if the file could not be mapped
+		 */
+		[Version (since="0.4.0-alpha")]
+		public static Seq<Bytes> of_mapped_file (string path, uint8 delimiter = '\n', TaskEnv? env = null)
+				throws FileError {
+			Bytes bytes = new MappedFile(path, false).get_bytes();
+			Spliterator<Bytes> spliter = new RecordSpliterator<Bytes>(bytes, delimiter,
+					(b, offset, length) => new Bytes.from_bytes(b, offset, length));
+			return new Seq<Bytes>(spliter, env);
+		}
+
+		/**
+		 * Creates a new sequential seq of the lines of the given file.
+		 *
+		 * The lines are separated by '\n', and do not contain the line
+		 * terminator; a trailing '\r' is also removed. The file is mapped
+		 * into memory and split like {@link of_mapped_file}; only the lines
+		 * themselves are copied into strings.
+		 *
+		 * The file must not be modified until the execution of the seq
+		 * pipeline is completed.
+		 *
+		 * @param path the path of the file
+		 * @param env a task environment. If not specified,
+		 * {@link TaskEnv.get_common_task_env} is used.
+		 * @return the result seq
+		 * @throws FileError if the file could not be mapped
+		 */
+		[Version (since="0.4.0-alpha")]
+		public static Seq<string> of_file_lines (string path, TaskEnv? env = null) throws FileError {
+			Bytes bytes = new MappedFile(path, false).get_bytes();
+			Spliterator<string> spliter = new RecordSpliterator<string>(bytes, '\n', (b, offset, length) => {
+				unowned uint8[] data = b.get_data();
+				if (length > 0 && data[offset + length - 1] == '\r') length--;
+				return length == 0 ? "" : ((string) ((uint8*) data + offset)).ndup(length);
+			});
+			return new Seq<string>(spliter, env);
+		}
+
 		/**
 		 * Creates a new sequential empty seq.
 		 * @return an empty sequential seq
@@ -330,6 +417,8 @@ namespace Gpseq {
 		}
 
 		private Container<G,void*>? _container;
+		private DefaultContainer<void*>? _source; // the first container
+		private CancelGuard? _guard;
 		private TaskEnv _task_env;
 		private bool _is_parallel;
 		private bool _is_closed;
@@ -344,12 +433,20 @@ namespace Gpseq {
 		 * {@link TaskEnv.get_common_task_env} is used.
 		 */
 		public Seq (Spliterator<G> spliterator, TaskEnv? env = null) {
-			_container = new DefaultContainer<G>(spliterator, null, new Consumer<G>());
+			var source = new DefaultContainer<G>(spliterator, null, new Consumer<G>());
+			_container = source;
+			_source = (DefaultContainer<void*>) source;
 			_task_env = env != null ? env : TaskEnv.get_common_task_env();
+			CancellationToken? token = _task_env.cancellation_token;
+			if (token != null) {
+				get_guard().token = token;
+			}
 		}
 
 		private Seq.from_other (Seq<G> seq, Container<G,void*> container) {
 			_container = container;
+			_source = seq._source;
+			_guard = seq._guard;
 			_task_env = seq._task_env;
 			_is_parallel = seq._is_parallel;
 		}
@@ -404,6 +501,7 @@ namespace Gpseq {
 		public void close () {
 			if (_is_closed) return;
 			_container = null;
+			_source = null;
 			_is_closed = true;
 		}
 
@@ -446,6 +544,64 @@ namespace Gpseq {
 			return result;
 		}
 
+		/**
+		 * Returns a new equivalent seq that is interrupted when the given
+		 * token is cancelled.
+		 *
+		 * The elements of the seq source are traversed with periodic checks of
+		 * the token, so a running terminal operation stops within one chunk of
+		 * elements after cancellation, and its future fails with
+		 * {@link CancellationError.CANCELLED}. Work which does not traverse
+		 * the source, such as sorting already buffered elements, is not
+		 * interrupted.
+		 *
+		 * The token replaces the one set previously on this seq or provided
+		 * by {@link TaskEnv.cancellation_token}.
+		 *
+		 * This is a stateless intermediate operation.
+		 *
+		 * @param token a cancellation token, or null to remove the existing one
+		 * @return a new equivalent seq that is interrupted by the token
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> with_cancellation (CancellationToken? token) {
+			assert(_is_closed == false);
+			get_guard().token = token;
+			return copy_and_close<G>(_container);
+		}
+
+		/**
+		 * Returns a new equivalent seq that is interrupted when the given
+		 * deadline has passed.
+		 *
+		 * This works like {@link with_cancellation}, but the future of a
+		 * terminal operation fails with {@link CancellationError.TIMED_OUT}.
+		 *
+		 * This is a stateless intermediate operation.
+		 *
+		 * @param deadline the monotonic time, in microseconds, after which the
+		 * seq is interrupted. see {@link GLib.get_monotonic_time}
+		 * @return a new equivalent seq that is interrupted at the deadline
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> with_deadline (int64 deadline) {
+			assert(_is_closed == false);
+			get_guard().deadline = deadline;
+			return copy_and_close<G>(_container);
+		}
+
+		/**
+		 * Gets the cancel guard of this pipeline, installing it on the source
+		 * if it has not been installed yet.
+		 */
+		private CancelGuard get_guard () {
+			if (_guard == null) {
+				_guard = new CancelGuard();
+				_source.guard(_guard);
+			}
+			return _guard;
+		}
+
 		/**
 		 * Returns an iterator for the elements of this seq.
 		 *
@@ -486,7 +642,8 @@ namespace Gpseq {
 		 */
 		public Future<int64?> count () {
 			assert(_is_closed == false);
-			if (_container.is_size_known && _container.estimated_size >= 0) {
+			if (SpliteratorCharacteristics.SIZED in _container.characteristics
+					|| (_container.is_size_known && _container.estimated_size >= 0)) {
 				int64 result = _container.estimated_size;
 				close();
 				return Future.of<int64?>(result);
@@ -515,6 +672,10 @@ namespace Gpseq {
 		 *
 		 * This is a stateful intermediate operation.
 		 *
+		 * If neither function is specified and this seq is sorted by
+		 * {@link order_by} without a compare function, equal elements are
+		 * adjacent and only the last seen element is remembered.
+		 *
 		 * @param hash a //non-interfering// and //stateless// hash function. if
 		 * not specified, {@link Gee.Functions.get_hash_func_for} is used to get
 		 * a proper function
@@ -527,12 +688,16 @@ namespace Gpseq {
 				owned HashDataFunc<G>? hash = null,
 				owned EqualDataFunc<G>? equal = null) {
 			assert(_is_closed == false);
+			bool natural = hash == null && equal == null;
 			if (_container.is_size_known && _container.estimated_size <= 1) {
 				return copy_and_close<G>(_container);
+			} else if (natural && SpliteratorCharacteristics.DISTINCT in _container.characteristics) {
+				return copy_and_close<G>(_container);
 			} else {
 				if (hash == null) hash = Functions.get_hash_func_for(element_type);
 				if (equal == null) equal = Functions.get_equal_func_for(element_type);
-				Container<G,G> container = new DistinctContainer<G>(_container, _container, (owned) hash, (owned) equal);
+				Container<G,G> container = new DistinctContainer<G>(
+						_container, _container, (owned) hash, (owned) equal, natural);
 				return copy_and_close<G>(container);
 			}
 		}
@@ -776,6 +941,10 @@ namespace Gpseq {
 			assert(_is_closed == false);
 			if (offset == 0 && length < 0) {
 				return copy_and_close<G>(_container);
+			} else if (can_fuse_top_k(offset, length)) {
+				Container<G,G> top = ((SortedContainer<G>) _container).to_top_k(offset + length);
+				Container<G,G> container = new SliceContainer<G>(top, top, offset, length, false);
+				return copy_and_close<G>(container);
 			} else {
 				Container<G,G> container = new SliceContainer<G>(_container, _container, offset, length, false);
 				return copy_and_close<G>(container);
@@ -849,12 +1018,62 @@ namespace Gpseq {
 			assert(_is_closed == false);
 			if (offset == 0 && length < 0) {
 				return copy_and_close<G>(_container);
+			} else if (can_fuse_top_k(offset, length)) {
+				Container<G,G> top = ((SortedContainer<G>) _container).to_top_k(offset + length);
+				Container<G,G> container = new SliceContainer<G>(top, top, offset, length, true);
+				return copy_and_close<G>(container);
 			} else {
 				Container<G,G> container = new SliceContainer<G>(_container, _container, offset, length, true);
 				return copy_and_close<G>(container);
 			}
 		}
 
+		/**
+		 * Whether or not a slice of this seq can be computed by selecting the
+		 * least elements instead of sorting all the elements, i.e. this seq
+		 * is a result of {@link order_by} and the slice is bounded and shorter
+		 * than the input.
+		 */
+		private bool can_fuse_top_k (int64 offset, int64 length) {
+			if (length < 0 || !(_container is SortedContainer<G>)) return false;
+			if (offset > MAX_ARRAY_LENGTH - length) return false;
+			return !_container.is_size_known || _container.estimated_size < 0
+					|| offset + length < _container.estimated_size;
+		}
+
+		/**
+		 * Returns a seq which contains the //k// least elements of this seq,
+		 * sorted based on the given compare function. The result is the same
+		 * as that of ''order_by(compare).limit_ordered(k)''.
+		 *
+		 * Each part of the input keeps only a bounded heap of its //k// least
+		 * elements, so this operation takes O(n log k) time and O(k) extra
+		 * memory per part. {@link order_by} followed by {@link limit},
+		 * {@link limit_ordered}, {@link chop}, or {@link chop_ordered} is
+		 * computed in the same way.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param k maximum number of elements the seq may contain
+		 * @param compare a //non-interfering// and //stateless// compare
+		 * function. if not specified, {@link Gee.Functions.get_compare_func_for}
+		 * is used to get a proper function
+		 * @return the new seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> top_k (int64 k, owned CompareDataFunc<G>? compare = null)
+			requires (k >= 0)
+		{
+			assert(_is_closed == false);
+			bool natural = compare == null;
+			if (compare == null) {
+				compare = Functions.get_compare_func_for(element_type);
+			}
+			Container<G,G> container = new TopKContainer<G>(
+					_container, _container, (owned) compare, natural, k);
+			return copy_and_close<G>(container);
+		}
+
 		/**
 		 * Returns a seq which contains the elements of this seq that match the
 		 * given predicate.
@@ -920,8 +1139,11 @@ namespace Gpseq {
 			} else {
 				return (Future<A>) future.map<A>(value => {
 					A result = identity;
-					container.each(g => {
-						result = accumulator(g, result);
+					container.each_chunk(chunk => {
+						for (int i = 0; i < chunk.length; i++) {
+							result = accumulator(chunk[i], result);
+						}
+						return true;
 					});
 					return result;
 				});
@@ -987,6 +1209,69 @@ namespace Gpseq {
 			}
 		}
 
+		/**
+		 * Returns a seq which contains the running totals of the elements of
+		 * this seq, in encounter order: the i-th element of the new seq is
+		 * //op(...op(op(identity, e0), e1)..., ei)//.
+		 *
+		 * The elements are stored in an array first. In parallel, the running
+		 * totals are computed by a two-pass parallel prefix: the totals of
+		 * blocks of the array are computed in parallel, and then each block is
+		 * rescanned in parallel starting with the total of the preceding
+		 * blocks. So //op// is called about twice as many times as in
+		 * sequential.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param op an //associative//, //non-interfering//, and
+		 * //stateless// function for combining two values
+		 * @param identity the identity value for combining values
+		 * @return the new seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> scan (owned CombineFunc<G> op, G identity) {
+			assert(_is_closed == false);
+			Container<G,G> container = new ScanContainer<G>(
+					_container, _container, (owned) op, identity);
+			return copy_and_close<G>(container);
+		}
+
+		/**
+		 * Returns a seq which contains the totals of the sliding windows of
+		 * the given size over the elements of this seq, in encounter order:
+		 * the i-th element of the new seq is //op(...op(ei, ei+1)..., ei+w-1)//
+		 * where //w// is the window size.
+		 *
+		 * The new seq contains //max(n - w + 1, 0)// elements where //n// is
+		 * the number of the elements of this seq. e.g. moving sums:
+		 *
+		 * {{{
+		 * Seq.of_array<int>({1, 2, 3, 4, 5}).sliding_reduce(3, (a, b) => a + b);
+		 * // 6, 9, 12
+		 * }}}
+		 *
+		 * The elements are stored in an array first. The windows are computed
+		 * from the suffix totals and the prefix totals of blocks of the window
+		 * size, so //op// is called about three times per element regardless
+		 * of the window size, and the windows are computed in parallel.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param window the window size
+		 * @param op an //associative//, //non-interfering//, and
+		 * //stateless// function for combining two values
+		 * @return the new seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> sliding_reduce (int window, owned CombineFunc<G> op)
+			requires (window > 0)
+		{
+			assert(_is_closed == false);
+			Container<G,G> container = new SlidingContainer<G>(
+					_container, _container, window, (owned) op);
+			return copy_and_close<G>(container);
+		}
+
 		/**
 		 * Returns a seq which contains the results of applying the given mapper
 		 * function to the elements of this seq.
@@ -1020,6 +1305,220 @@ namespace Gpseq {
 			return copy_and_close<A>(container);
 		}
 
+		/**
+		 * Returns a seq which contains the elements of the spliterators
+		 * produced by applying the given mapper function to the elements of
+		 * this seq.
+		 *
+		 * Unlike {@link flat_map}, the inner spliterators can be split, so an
+		 * element that expands to many elements is processed in parallel
+		 * rather than by one thread. Splitting first divides the elements of
+		 * this seq; when they can not be divided any more, an element is
+		 * mapped and its spliterator is split.
+		 *
+		 * The size of the new seq is known once all the elements of this seq
+		 * have been mapped, and then it is the sum of the sizes of the
+		 * remaining inner spliterators, if known. Before that, it is
+		 * estimated from the sizes of the inner spliterators mapped so far.
+		 * In parallel, an inner spliterator is split as finely as a seq of
+		 * its own size would be.
+		 *
+		 * This is a stateless intermediate operation.
+		 *
+		 * @param mapper a //non-interfering// and //stateless// mapping
+		 * function
+		 * @return the new seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<A> flat_map_spliterator<A> (owned SpliteratorFlatMapFunc<A,G> mapper) {
+			assert(_is_closed == false);
+			Container<A,G> container = new SplittableFlatMappedContainer<A,G>(
+					_container, _container, (owned) mapper);
+			return copy_and_close<A>(container);
+		}
+
+		/**
+		 * Returns a seq which contains the elements of the seqs produced by
+		 * applying the given mapper function to the elements of this seq.
+		 *
+		 * This is equivalent to:
+		 *
+		 * {{{
+		 * seq.flat_map_spliterator<A>(g => mapper(g).spliterator());
+		 * }}}
+		 *
+		 * The inner seqs are split only if they are parallel.
+		 *
+		 * This is a stateless intermediate operation.
+		 *
+		 * @param mapper a //non-interfering// and //stateless// mapping
+		 * function
+		 * @return the new seq
+		 * @see flat_map_spliterator
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<A> flat_map_seq<A> (owned SeqFlatMapFunc<A,G> mapper) {
+			return flat_map_spliterator<A>(g => mapper(g).spliterator());
+		}
+
+		/**
+		 * Returns a seq which contains the results of applying the given
+		 * combiner function to each pair of an element of this seq and an
+		 * element of the other seq that have equal keys.
+		 *
+		 * This is a hash join. The other seq is collected into a hash table
+		 * when the terminal operation starts, in parallel if this seq or the
+		 * other seq is parallel; and then the elements of this seq are
+		 * streamed through the table. The results are in the encounter order
+		 * of this seq, and the matches of an element are in the encounter
+		 * order of the other seq.
+		 *
+		 * The keys are hashed and compared by the results of
+		 * {@link Gee.Functions.get_hash_func_for} and
+		 * {@link Gee.Functions.get_equal_func_for}.
+		 *
+		 * The other seq is consumed by this operation.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param other the other seq
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * this seq
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @param combiner a //non-interfering// and //stateless// function
+		 * combining the matched elements
+		 * @return the new seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<R> join<H,K,R> (Seq<H> other, owned MapFunc<K,G> key,
+				owned MapFunc<K,H> other_key, owned JoinFunc<R,G,H> combiner) {
+			assert(_is_closed == false);
+			Container<R,G> container = new JoinContainer<R,G,K,H>(
+					_container, _container, JoinContainer.Kind.INNER, other,
+					(owned) key, (owned) other_key, (owned) combiner);
+			return copy_and_close<R>(container);
+		}
+
+		/**
+		 * Returns a seq which contains the results of applying the given
+		 * combiner function to each pair of an element of this seq and an
+		 * element of the other seq that have equal keys, and to each element
+		 * of this seq that has no match, paired with null.
+		 *
+		 * This is equivalent to {@link join}, except that the unmatched
+		 * elements of this seq are included.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param other the other seq
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * this seq
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @param combiner a //non-interfering// and //stateless// function
+		 * combining the matched elements
+		 * @return the new seq
+		 * @see join
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<R> left_join<H,K,R> (Seq<H> other, owned MapFunc<K,G> key,
+				owned MapFunc<K,H> other_key, owned JoinFunc<R,G,H> combiner) {
+			assert(_is_closed == false);
+			Container<R,G> container = new JoinContainer<R,G,K,H>(
+					_container, _container, JoinContainer.Kind.LEFT, other,
+					(owned) key, (owned) other_key, (owned) combiner);
+			return copy_and_close<R>(container);
+		}
+
+		/**
+		 * Returns a seq which contains the elements of this seq that have an
+		 * element of the other seq with an equal key.
+		 *
+		 * Each element is included at most once, no matter how many matches
+		 * it has. See {@link join} for how the keys are matched.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param other the other seq
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * this seq
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @return the new seq
+		 * @see join
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> semi_join<H,K> (Seq<H> other, owned MapFunc<K,G> key,
+				owned MapFunc<K,H> other_key) {
+			assert(_is_closed == false);
+			Container<G,G> container = new JoinContainer<G,G,K,H>(
+					_container, _container, JoinContainer.Kind.SEMI, other,
+					(owned) key, (owned) other_key, (g, h) => g);
+			return copy_and_close<G>(container);
+		}
+
+		/**
+		 * Returns a seq which contains the elements of this seq that have no
+		 * element of the other seq with an equal key.
+		 *
+		 * See {@link join} for how the keys are matched.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param other the other seq
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * this seq
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @return the new seq
+		 * @see join
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<G> anti_join<H,K> (Seq<H> other, owned MapFunc<K,G> key,
+				owned MapFunc<K,H> other_key) {
+			assert(_is_closed == false);
+			Container<G,G> container = new JoinContainer<G,G,K,H>(
+					_container, _container, JoinContainer.Kind.ANTI, other,
+					(owned) key, (owned) other_key, (g, h) => g);
+			return copy_and_close<G>(container);
+		}
+
+		/**
+		 * Returns a seq which contains the results of applying the given
+		 * combiner function to each key of this seq or the other seq, with
+		 * the elements of both seqs that have the key.
+		 *
+		 * Both seqs are collected into hash tables when the terminal operation
+		 * starts, in parallel if this seq is parallel, and the groups are
+		 * combined in parallel. The elements of a group are in encounter order.
+		 * The results are in an unspecified order, but the order is the same
+		 * for the same inputs and the same number of threads. See {@link join}
+		 * for how the keys are matched.
+		 *
+		 * The other seq is consumed by this operation.
+		 *
+		 * This is a stateful intermediate operation.
+		 *
+		 * @param other the other seq
+		 * @param key a //non-interfering// and //stateless// key function of
+		 * this seq
+		 * @param other_key a //non-interfering// and //stateless// key
+		 * function of the other seq
+		 * @param combiner a //non-interfering// and //stateless// function
+		 * combining the groups of a key
+		 * @return the new seq
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Seq<R> co_group<H,K,R> (Seq<H> other, owned MapFunc<K,G> key,
+				owned MapFunc<K,H> other_key, owned CoGroupFunc<R,K,G,H> combiner) {
+			assert(_is_closed == false);
+			Container<R,G> container = new CoGroupContainer<R,G,K,H>(
+					_container, _container, other,
+					(owned) key, (owned) other_key, (owned) combiner);
+			return copy_and_close<R>(container);
+		}
+
 		/**
 		 * Returns the maximum element of this seq, based on the given compare
 		 * function.
@@ -1072,6 +1571,10 @@ namespace Gpseq {
 		 *
 		 * This is a stateful intermediate operation.
 		 *
+		 * If the compare function is not specified and this seq has already
+		 * been sorted by the default compare function, the elements are not
+		 * sorted again.
+		 *
 		 * @param compare a //non-interfering// and //stateless// compare
 		 * function. if not specified, {@link Gee.Functions.get_compare_func_for}
 		 * is used to get a proper function
@@ -1079,13 +1582,17 @@ namespace Gpseq {
 		 */
 		public Seq<G> order_by (owned CompareDataFunc<G>? compare = null) {
 			assert(_is_closed == false);
+			bool natural = compare == null;
 			if (_container.is_size_known && _container.estimated_size <= 1) {
 				return copy_and_close<G>(_container);
+			} else if (natural && SpliteratorCharacteristics.SORTED in _container.characteristics) {
+				return copy_and_close<G>(_container);
 			} else {
 				if (compare == null) {
 					compare = Functions.get_compare_func_for(element_type);
 				}
-				Container<G,G> container = new SortedContainer<G>(_container, _container, (owned) compare);
+				Container<G,G> container = new SortedContainer<G>(
+						_container, _container, (owned) compare, natural);
 				return copy_and_close<G>(container);
 			}
 		}
@@ -1229,8 +1736,11 @@ namespace Gpseq {
 				close();
 				return (Future<R>) future.map<R>(value => {
 					A accumulator = collector.create_accumulator();
-					container.each(g => {
-						collector.accumulate(g, accumulator);
+					container.each_chunk(chunk => {
+						for (int i = 0; i < chunk.length; i++) {
+							collector.accumulate(chunk[i], accumulator);
+						}
+						return true;
 					});
 					return collector.finish(accumulator);
 				});
@@ -1294,6 +1804,15 @@ namespace Gpseq {
 		 * seq.collect( Collectors.to_generic_array<G>() );
 		 * }}}
 		 *
+		 * If the exact number of the elements is known before traversal, and
+		 * stays known when the seq is split -- e.g. a seq of an array or a
+		 * range followed only by {@link map} operations -- the result array
+		 * is allocated once, and each element is stored directly at its
+		 * index, without intermediate arrays.
+		 * If a spliterator of the seq then does not have as many elements as
+		 * its exact size, the future fails with
+		 * {@link SpliteratorError.SIZE_MISMATCH}.
+		 *
 		 * This is a terminal operation.
 		 *
 		 * @return a future of the result generic array
@@ -1301,9 +1820,46 @@ namespace Gpseq {
 		 */
 		[Version (since="0.4.0-alpha")]
 		public Future<GenericArray<G>> to_generic_array () {
+			assert(_is_closed == false);
+			SpliteratorCharacteristics exact = SpliteratorCharacteristics.SIZED
+					| SpliteratorCharacteristics.SUBSIZED;
+			if ((_container.characteristics & exact) == exact
+					&& _container.estimated_size <= MAX_ARRAY_LENGTH) {
+				return to_placed_generic_array();
+			}
 			return collect( Collectors.to_generic_array<G>() );
 		}
 
+		private Future<GenericArray<G>> to_placed_generic_array () {
+			Future<void*> future = _container.start(this);
+			Container<G,void*> container = (!)_container;
+			bool parallel = _is_parallel;
+			close();
+			return (Future<GenericArray<G>>) future.flat_map<GenericArray<G>>(value => {
+				int len = (int) container.estimated_size;
+				var array = new GenericArray<G>(len);
+				array.set_size(len);
+				var dest = new SubArray<G>(array.data);
+				if (parallel) {
+					int64 threshold = _task_env.resolve_threshold(len, _task_env.executor.parallels);
+					int max_depth = _task_env.resolve_max_depth(len, _task_env.executor.parallels);
+					PlaceTask<G> task = new PlaceTask<G>(dest, 0, container, null,
+							threshold, max_depth, _task_env.executor);
+					task.fork();
+					return task.future.map<GenericArray<G>>(v => array);
+				} else {
+					try {
+						PlaceTask.place<G>(dest, 0, len, container);
+						return Future.of<GenericArray<G>>(array);
+					} catch (Error err) {
+						var promise = new Promise<GenericArray<G>>();
+						promise.set_exception((owned) err);
+						return promise.future;
+					}
+				}
+			});
+		}
+
 		/**
 		 * Accumulates the elements into a new list, in encounter order.
 		 *
@@ -79,6 +79,13 @@ namespace Gpseq {
 			}
 		}
 
+		public SpliteratorCharacteristics characteristics {
+			get {
+				// not splittable, therefore SUBSIZED is meaningless
+				return _spliterator.characteristics & ~SpliteratorCharacteristics.SUBSIZED;
+			}
+		}
+
 		public void each (Func<G> f) throws Error {
 			each_chunk(chunk => {
 				for (int i = 0; i < chunk.length; i++) {
@@ -35,6 +35,7 @@ namespace Gpseq {
 		 * @param skip the number of elements to skip
 		 * @param limit maximum number of elements the spliterator may contain,
 		 * or a negative value if unlimited
+		 * @param ordered whether or not the slice preserves the encounter order
 		 */
 		public SliceContainer (Spliterator<G> spliterator,
 				Container<G,void*> parent, int64 skip, int64 limit, bool ordered)
@@ -44,6 +45,16 @@ namespace Gpseq {
 			_skip = skip;
 			_limit = limit;
 			_ordered = ordered;
+
+			SpliteratorCharacteristics c = spliterator.characteristics;
+			if (_ordered) {
+				c &= SpliteratorCharacteristics.ORDERED
+					| SpliteratorCharacteristics.SORTED
+					| SpliteratorCharacteristics.DISTINCT;
+			} else {
+				c &= SpliteratorCharacteristics.DISTINCT;
+			}
+			set_characteristics(c);
 		}
 
 		private SliceContainer.copy (SliceContainer<G> container, Spliterator<G> spliterator) {
@@ -69,7 +80,8 @@ namespace Gpseq {
 				return Future.of<void*>(null);
 			} else if (_ordered) {
 				// XXX perform unordered slice if the spliterator is unordered.
-				// this needs to add 'attributes' flags to spliterator.
+				// spliterators that don't override characteristics report no
+				// ORDERED flag, so the flag can't be used to decide it yet.
 				// TODO optimize when the exact size of the spliterator is
 				// known and the spliterator doesn't cover infinite elements.
 				int64 len = estimated_size;
@@ -0,0 +1,128 @@
+/* SlidingContainer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/*
+	 * A container which contains the totals of the sliding windows of a
+	 * fixed size over the elements of a input, in encounter order.
+	 */
+	internal class SlidingContainer<G> : DefaultContainer<G> {
+		private CombineFunc<G>? _op;
+		private int _window;
+
+		/**
+		 * Creates a new sliding container.
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new container
+		 * @param window the window size
+		 * @param op an associative, //non-interfering// and //stateless//
+		 * combine function
+		 */
+		public SlidingContainer (Spliterator<G> spliterator, Container<G,void*> parent,
+				int window, owned CombineFunc<G> op)
+			requires (window > 0)
+		{
+			base(spliterator, parent, new Consumer<G>());
+			_window = window;
+			_op = (owned) op;
+			// the size is known only after the input is stored in an array
+			set_characteristics(SpliteratorCharacteristics.ORDERED);
+		}
+
+		private SlidingContainer.copy (SlidingContainer<G> container, Spliterator<G> spliterator) {
+			base(spliterator, container.parent, container.consumer);
+		}
+
+		protected override DefaultContainer<G> make_container (Spliterator<G> spliterator) {
+			return new SlidingContainer<G>.copy(this, spliterator);
+		}
+
+		public override int64 estimated_size {
+			get {
+				int64 size = spliterator.estimated_size;
+				if (parent == null || size < 0) return size;
+				return int64.max(size - _window + 1, 0);
+			}
+		}
+
+		public override Future<void*> start (Seq seq) {
+			var future = parent != null ? parent.start(seq) : Future.of<void*>(null);
+			set_parent(null);
+			return (Future<void*>) future.flat_map<void*>(value => {
+				try {
+					return aggregate(seq);
+				} catch (Error err) {
+					var promise = new Promise<void*>();
+					promise.set_exception((owned) err);
+					return promise.future;
+				}
+			});
+		}
+
+		private Future<void*> aggregate (Seq seq) throws Error {
+			G[] array = spliter_to_array();
+			int len = array.length;
+			if (len < _window) {
+				spliterator = new ArraySpliterator<G>({}, 0, 0);
+				return Future.of<void*>(null);
+			} else if (_window == 1) {
+				spliterator = new ArraySpliterator<G>((owned) array, 0, len);
+				return Future.of<void*>(null);
+			}
+
+			G[] suffixes = new G[len];
+			SubArray<G> sub = new SubArray<G>(array);
+			SubArray<G> suffixes_sub = new SubArray<G>(suffixes);
+			int blocks = (len + _window - 1) / _window;
+			int windows = len - _window + 1;
+			TaskEnv env = seq.task_env;
+			Executor executor = env.executor;
+			int threads = executor.parallels;
+
+			if (!seq.is_parallel || threads <= 1) {
+				var task = new SlidingTask<G>(SlidingTask.Phase.BLOCKS, sub, suffixes_sub, _window,
+						_op, 0, blocks, null, int64.MAX, 0, executor);
+				task.invoke();
+				task = new SlidingTask<G>(SlidingTask.Phase.WINDOWS, sub, suffixes_sub, _window,
+						_op, 0, windows, null, int64.MAX, 0, executor);
+				task.invoke();
+				spliterator = new ArraySpliterator<G>((owned) suffixes, 0, windows);
+				return Future.of<void*>(null);
+			}
+
+			int64 threshold = env.resolve_threshold(len, threads);
+			int max_depth = env.resolve_max_depth(len, threads);
+			int64 block_threshold = int64.max(threshold / _window, 1);
+			var blocks_task = new SlidingTask<G>(SlidingTask.Phase.BLOCKS, sub, suffixes_sub, _window,
+					_op, 0, blocks, null, block_threshold, max_depth, executor);
+			blocks_task.fork();
+			return (Future<void*>) blocks_task.future.flat_map<void*>(value => {
+				var windows_task = new SlidingTask<G>(SlidingTask.Phase.WINDOWS, sub, suffixes_sub, _window,
+						_op, 0, windows, null, threshold, max_depth, executor);
+				windows_task.fork();
+				return windows_task.future.map<void*>(v => {
+					spliterator = new ArraySpliterator<G>((owned) suffixes, 0, windows);
+					array = null;
+					return null;
+				});
+			});
+		}
+	}
+}
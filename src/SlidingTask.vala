@@ -0,0 +1,118 @@
+/* SlidingTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A task for one pass of a sliding window aggregation.
+	 *
+	 * The array is divided into blocks of the window size. A window either
+	 * is a block, or spans the suffix of a block and the prefix of the next
+	 * block, so its total is //suffix[i] + prefix[i + window - 1]//.
+	 *
+	 * The {@link Phase.BLOCKS} pass ranges over block indices; it stores the
+	 * suffix totals in //suffixes//, and replaces the elements with the
+	 * prefix totals in place. The {@link Phase.WINDOWS} pass ranges over
+	 * window indices; it replaces the suffix totals with the window totals
+	 * in place.
+	 */
+	internal class SlidingTask<G> : RangeTask<void*> {
+		internal enum Phase {
+			BLOCKS,
+			WINDOWS
+		}
+
+		private Phase _phase;
+		private SubArray<G> _array;
+		private SubArray<G> _suffixes;
+		private int _window;
+		private unowned CombineFunc<G> _op;
+
+		/**
+		 * Creates a new sliding task.
+		 *
+		 * @param phase the pass of this task
+		 * @param array the elements, which are replaced with the prefix totals
+		 * by the blocks pass
+		 * @param suffixes the suffix totals, which are replaced with the
+		 * window totals by the windows pass
+		 * @param window the window size
+		 * @param op an associative combine function
+		 * @param start the index of the first block or window
+		 * @param end the index after the last block or window
+		 * @param parent the parent of this task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public SlidingTask (Phase phase, SubArray<G> array, SubArray<G> suffixes, int window,
+				CombineFunc<G> op, int start, int end, SlidingTask<G>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(start, end, parent, threshold, max_depth, executor);
+			_phase = phase;
+			_array = array;
+			_suffixes = suffixes;
+			_window = window;
+			_op = op;
+		}
+
+		protected override void* leaf_compute (int start, int end) throws Error {
+			if (_phase == Phase.BLOCKS) {
+				for (int b = start; b < end; b++) {
+					int lo = b * _window;
+					compute_block(lo, int.min(lo + _window, _array.size));
+				}
+			} else {
+				for (int i = start; i < end; i++) {
+					if (i % _window != 0) {
+						// the last element of the window holds its prefix total
+						_suffixes[i] = _op(_suffixes[i], _array[i + _window - 1]);
+					}
+				}
+			}
+			return null;
+		}
+
+		private void compute_block (int lo, int hi) throws Error {
+			G acc = _array[hi - 1];
+			_suffixes[hi - 1] = acc;
+			for (int i = hi - 2; i >= lo; i--) {
+				acc = _op(_array[i], (owned) acc);
+				_suffixes[i] = acc;
+			}
+			acc = _array[lo];
+			for (int i = lo + 1; i < hi; i++) {
+				acc = _op((owned) acc, _array[i]);
+				_array[i] = acc;
+			}
+		}
+
+		protected override void* merge_results (owned void* left, owned void* right) {
+			return null;
+		}
+
+		protected override RangeTask<void*> make_child (int start, int end) {
+			var task = new SlidingTask<G>(_phase, _array, _suffixes, _window, _op, start, end,
+					this, threshold, max_depth, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
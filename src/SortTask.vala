@@ -23,11 +23,18 @@ using Gee;
 namespace Gpseq {
 	/**
 	 * A fork-join task that performs a sort operation.
+	 *
+	 * The sorted halves are merged through a temporary array of the same
+	 * length, or, if the task is created with {@link SortTask.in_place},
+	 * merged in place by rotations, with buffers bounded by
+	 * MERGE_BUFFER_SIZE.
 	 */
 	internal class SortTask<G> : ForkJoinTask<void*> {
+		private const int MERGE_BUFFER_SIZE = 1024;
+
 		private SubArray<G> _array;
 		private G[] _owned_temp;
-		private SubArray<G> _temp;
+		private SubArray<G>? _temp; // null if in place
 		private Comparator<G> _comparator;
 
 		/**
@@ -55,11 +62,32 @@ namespace Gpseq {
 			_comparator = comparator;
 		}
 
+		/**
+		 * Creates a new sort task which does not use a temporary array.
+		 *
+		 * @param array a sub array
+		 * @param comparator a comparator
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public SortTask.in_place (
+				SubArray<G> array, Comparator<G> comparator,
+				SortTask<G>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(parent, threshold, max_depth, executor);
+			_array = array;
+			_temp = null;
+			_comparator = comparator;
+		}
+
 		private SortTask.sub (
-				SubArray<G> array, SubArray<G> temp, Comparator<G> comparator,
+				SubArray<G> array, SubArray<G>? temp, Comparator<G> comparator,
 				SortTask<G>? parent,
 				int64 threshold, int max_depth, Executor executor)
-			requires (temp.size >= array.size)
+			requires (temp == null || temp.size >= array.size)
 		{
 			base(parent, threshold, max_depth, executor);
 			_array = array;
@@ -69,7 +97,7 @@ namespace Gpseq {
 
 		public override void compute () {
 			if (shared_result.ready || is_cancelled) {
-				promise.set_value(null);
+				return_value(null);
 				return;
 			}
 
@@ -79,11 +107,11 @@ namespace Gpseq {
 			} else {
 				int mid = size >> 1;
 				SubArray<G> left_array = _array.sub_array(0, mid);
-				SubArray<G> left_temp = _temp.sub_array(0, mid);
+				SubArray<G>? left_temp = _temp != null ? _temp.sub_array(0, mid) : null;
 				SortTask<G> left = copy(left_array, left_temp);
 				left.fork();
 				SubArray<G> right_array = _array.sub_array(mid, size);
-				SubArray<G> right_temp = _temp.sub_array(mid, size);
+				SubArray<G>? right_temp = _temp != null ? _temp.sub_array(mid, size) : null;
 				SortTask<G> right = copy(right_array, right_temp);
 
 				try {
@@ -96,13 +124,13 @@ namespace Gpseq {
 			}
 
 			if (is_root && shared_result.ready) {
-				shared_result.bake_promise(promise);
+				shared_result.bake(this);
 			} else {
-				promise.set_value(null);
+				return_value(null);
 			}
 		}
 
-		private SortTask<G> copy (SubArray<G> array, SubArray<G> temp) {
+		private SortTask<G> copy (SubArray<G> array, SubArray<G>? temp) {
 			var task = new SortTask<G>.sub(
 					array, temp, _comparator,
 					this, threshold, max_depth, executor);
@@ -120,6 +148,15 @@ namespace Gpseq {
 				return; // already sorted
 			}
 
+			if (_temp == null) {
+				var in_place = new InPlaceMergeTask<G>(
+						(void**) _array.get_data(), 0, ary0.size, _array.size,
+						_comparator, this, threshold, max_depth, executor);
+				in_place.depth = depth;
+				in_place.invoke();
+				return;
+			}
+
 			MergeTask<G> task = new MergeTask<G>(
 					ary0, ary1, _temp, _comparator,
 					this, threshold, max_depth, executor);
@@ -156,7 +193,7 @@ namespace Gpseq {
 
 			public override void compute () {
 				if (shared_result.ready || is_cancelled) {
-					promise.set_value(null);
+					return_value(null);
 					return;
 				}
 
@@ -166,10 +203,10 @@ namespace Gpseq {
 				int len_r = right.size;
 
 				if (len_l == 0) {
-					promise.set_value(null);
+					return_value(null);
 				} else if (len_l + len_r <= threshold || 0 <= max_depth <= depth) {
 					sequential_merge(left, right, _output);
-					promise.set_value(null);
+					return_value(null);
 				} else {
 					int q = (len_l-1) >> 1;
 					int q2 = binary_search(left[q], right);
@@ -186,7 +223,7 @@ namespace Gpseq {
 					} catch (Error err) {
 						shared_result.error = (owned) err;
 					}
-					promise.set_value(null);
+					return_value(null);
 				}
 			}
 
@@ -228,5 +265,229 @@ namespace Gpseq {
 				return hi;
 			}
 		}
+
+		/**
+		 * Merges two adjacent sorted runs in place.
+		 *
+		 * The longer run is split at its middle element, the other run is
+		 * split at the position of that element, and the two middle parts are
+		 * swapped by a rotation. This leaves two independent, smaller merges,
+		 * which are run in parallel. Once the shorter run fits in
+		 * MERGE_BUFFER_SIZE, it is copied into a small buffer and merged
+		 * directly.
+		 *
+		 * The elements are moved as raw pointers, so their reference counts
+		 * are never touched.
+		 */
+		private class InPlaceMergeTask<G> : ForkJoinTask<void*> {
+			private void** _data;
+			private int _lo;
+			private int _mid;
+			private int _hi;
+			private Comparator<G> _comparator;
+
+			public InPlaceMergeTask (
+					void** data, int lo, int mid, int hi,
+					Comparator<G> comparator, ForkJoinTask<void*>? parent,
+					int64 threshold, int max_depth, Executor executor) {
+				base(parent, threshold, max_depth, executor);
+				_data = data;
+				_lo = lo;
+				_mid = mid;
+				_hi = hi;
+				_comparator = comparator;
+			}
+
+			public override void compute () {
+				if (shared_result.ready || is_cancelled) {
+					return_value(null);
+					return;
+				}
+
+				int lo = _lo;
+				int mid = _mid;
+				int hi = _hi;
+				if (lo == mid || mid == hi) {
+					return_value(null);
+				} else if (hi - lo <= threshold || 0 <= max_depth <= depth) {
+					sequential_merge(lo, mid, hi);
+					return_value(null);
+				} else {
+					int first_mid, first_hi, second_lo, second_mid;
+					split(lo, mid, hi, out first_mid, out first_hi,
+							out second_lo, out second_mid);
+					var task = copy(lo, first_mid, first_hi);
+					task.fork();
+					var task2 = copy(second_lo, second_mid, hi);
+					try {
+						task2.invoke();
+						task.join();
+					} catch (Error err) {
+						shared_result.error = (owned) err;
+					}
+					return_value(null);
+				}
+			}
+
+			/**
+			 * Splits the merge of [lo, mid) and [mid, hi) into the merges of
+			 * [lo, first_mid) and [first_mid, first_hi), and of
+			 * [second_lo, second_mid) and [second_mid, hi).
+			 *
+			 * The split element ends up at first_hi, between the two merges.
+			 */
+			private void split (int lo, int mid, int hi,
+					out int first_mid, out int first_hi,
+					out int second_lo, out int second_mid) {
+				int p, q, pos;
+				if (mid - lo >= hi - mid) {
+					// left[p] goes after all right elements less than it
+					p = lo + ((mid - lo) >> 1);
+					q = lower_bound(mid, hi, _data[p]);
+					rotate(p, mid, q);
+					pos = p + (q - mid);
+					second_mid = q;
+				} else {
+					// right[q] goes after all left elements less than or equal to it
+					q = mid + ((hi - mid) >> 1);
+					p = upper_bound(lo, mid, _data[q]);
+					rotate(p, mid, q + 1);
+					pos = p + (q - mid);
+					second_mid = q + 1;
+				}
+				first_mid = p;
+				first_hi = pos;
+				second_lo = pos + 1;
+			}
+
+			private void sequential_merge (int lo, int mid, int hi) {
+				while (mid - lo > MERGE_BUFFER_SIZE && hi - mid > MERGE_BUFFER_SIZE) {
+					int first_mid, first_hi, second_lo, second_mid;
+					split(lo, mid, hi, out first_mid, out first_hi,
+							out second_lo, out second_mid);
+					// recurse into the smaller merge, loop on the larger one
+					if (first_hi - lo <= hi - second_lo) {
+						sequential_merge(lo, first_mid, first_hi);
+						lo = second_lo;
+						mid = second_mid;
+					} else {
+						sequential_merge(second_lo, second_mid, hi);
+						mid = first_mid;
+						hi = first_hi;
+					}
+				}
+				if (lo == mid || mid == hi) return;
+				if (mid - lo <= hi - mid) {
+					merge_forward(lo, mid, hi);
+				} else {
+					merge_backward(lo, mid, hi);
+				}
+			}
+
+			/**
+			 * Merges with a buffer holding the left run.
+			 */
+			private void merge_forward (int lo, int mid, int hi) {
+				int len = mid - lo;
+				void*[] buf = new void*[len];
+				Memory.copy(buf, _data + lo, sizeof(void*) * len);
+				int i = 0;
+				int j = mid;
+				int k = lo;
+				while (i < len && j < hi) {
+					if (compare(_data[j], buf[i]) < 0) {
+						_data[k++] = _data[j++];
+					} else {
+						_data[k++] = buf[i++];
+					}
+				}
+				while (i < len) {
+					_data[k++] = buf[i++];
+				}
+			}
+
+			/**
+			 * Merges with a buffer holding the right run.
+			 */
+			private void merge_backward (int lo, int mid, int hi) {
+				int len = hi - mid;
+				void*[] buf = new void*[len];
+				Memory.copy(buf, _data + mid, sizeof(void*) * len);
+				int i = mid - 1;
+				int j = len - 1;
+				int k = hi - 1;
+				while (i >= lo && j >= 0) {
+					if (compare(buf[j], _data[i]) < 0) {
+						_data[k--] = _data[i--];
+					} else {
+						_data[k--] = buf[j--];
+					}
+				}
+				while (j >= 0) {
+					_data[k--] = buf[j--];
+				}
+			}
+
+			private inline int compare (void* a, void* b) {
+				return _comparator.compare((G) a, (G) b);
+			}
+
+			/**
+			 * @return the first index in [lo, hi) whose element is not less
+			 * than the given element, or hi
+			 */
+			private int lower_bound (int lo, int hi, void* find) {
+				while (lo < hi) {
+					int m = (lo + hi) >> 1;
+					if (compare(_data[m], find) < 0) {
+						lo = m + 1;
+					} else {
+						hi = m;
+					}
+				}
+				return lo;
+			}
+
+			/**
+			 * @return the first index in [lo, hi) whose element is greater
+			 * than the given element, or hi
+			 */
+			private int upper_bound (int lo, int hi, void* find) {
+				while (lo < hi) {
+					int m = (lo + hi) >> 1;
+					if (compare(find, _data[m]) < 0) {
+						hi = m;
+					} else {
+						lo = m + 1;
+					}
+				}
+				return lo;
+			}
+
+			/**
+			 * Swaps [lo, mid) and [mid, hi).
+			 */
+			private void rotate (int lo, int mid, int hi) {
+				reverse(lo, mid);
+				reverse(mid, hi);
+				reverse(lo, hi);
+			}
+
+			private void reverse (int lo, int hi) {
+				for (int i = lo, j = hi - 1; i < j; i++, j--) {
+					void* t = _data[i];
+					_data[i] = _data[j];
+					_data[j] = t;
+				}
+			}
+
+			private InPlaceMergeTask<G> copy (int lo, int mid, int hi) {
+				var task = new InPlaceMergeTask<G>(
+						_data, lo, mid, hi, _comparator,
+						this, threshold, max_depth, executor);
+				task.depth = depth + 1;
+				return task;
+			}
+		}
 	}
 }
@@ -25,6 +25,7 @@ namespace Gpseq {
 	 */
 	internal class SortedContainer<G> : DefaultContainer<G> {
 		private CompareDataFunc<G>? _compare;
+		private bool _natural;
 
 		/**
 		 * Creates a new sorted container.
@@ -32,11 +33,24 @@ namespace Gpseq {
 		 * @param parent the parent of the new container
 		 * @param compare a //non-interfering// and //stateless// compare
 		 * function
+		 * @param natural whether or not //compare// is the default compare
+		 * function of the element type
 		 */
 		public SortedContainer (Spliterator<G> spliterator, Container<G,void*> parent,
-				owned CompareDataFunc<G> compare) {
+				owned CompareDataFunc<G> compare, bool natural) {
 			base(spliterator, parent, new Consumer<G>());
 			_compare = (owned) compare;
+			_natural = natural;
+
+			SpliteratorCharacteristics input = spliterator.characteristics;
+			SpliteratorCharacteristics c = SpliteratorCharacteristics.ORDERED;
+			c |= input & (SpliteratorCharacteristics.DISTINCT | SpliteratorCharacteristics.SIZED);
+			if (SpliteratorCharacteristics.SIZED in input) {
+				// the input is stored in an array before traversal
+				c |= SpliteratorCharacteristics.SUBSIZED;
+			}
+			if (natural) c |= SpliteratorCharacteristics.SORTED;
+			set_characteristics(c);
 		}
 
 		private SortedContainer.copy (SortedContainer<G> container, Spliterator<G> spliterator) {
@@ -47,6 +61,22 @@ namespace Gpseq {
 			return new SortedContainer<G>.copy(this, spliterator);
 		}
 
+		/**
+		 * Creates a top-k container which contains the first //k// elements of
+		 * this container, with the same input and compare function.
+		 *
+		 * The compare function is moved to the returned container, so this
+		 * container must not be used after calling this method.
+		 *
+		 * @param k the number of elements
+		 * @return the new top-k container
+		 */
+		internal TopKContainer<G> to_top_k (int64 k)
+			requires (k >= 0)
+		{
+			return new TopKContainer<G>(spliterator, parent, (owned) _compare, _natural, k);
+		}
+
 		public override Future<void*> start (Seq seq) {
 			var future = parent != null ? parent.start(seq) : Future.of<void*>(null);
 			set_parent(null);
@@ -66,14 +96,22 @@ namespace Gpseq {
 			SubArray<G> sub = new SubArray<G>(array);
 			int len = array.length;
 			if (seq.is_parallel) {
-				G[] temp = new G[len];
 				Comparator<G> cmp = new Comparator<G>((owned) _compare);
 				int64 threshold = seq.task_env.resolve_threshold(len, seq.task_env.executor.parallels);
 				int max_depth = seq.task_env.resolve_max_depth(len, seq.task_env.executor.parallels);
 
-				SortTask<G> task = new SortTask<G>(
-						sub, (owned)temp, cmp,
-						null, threshold, max_depth, seq.task_env.executor);
+				SortTask<G> task;
+				if (len > IN_PLACE_SORT_THRESHOLD) {
+					// a temporary array would double the memory of huge seqs
+					task = new SortTask<G>.in_place(
+							sub, cmp,
+							null, threshold, max_depth, seq.task_env.executor);
+				} else {
+					G[] temp = new G[len];
+					task = new SortTask<G>(
+							sub, (owned)temp, cmp,
+							null, threshold, max_depth, seq.task_env.executor);
+				}
 				task.fork();
 				return (Future<void*>) task.future.map<void*>(value => {
 					spliterator = new ArraySpliterator<G>((owned) array, 0, len);
@@ -85,52 +123,5 @@ namespace Gpseq {
 				return Future.of<void*>(null);
 			}
 		}
-
-		private G[] spliter_to_array () throws Error {
-			G[] array;
-			if (!spliterator.is_size_known || spliterator.estimated_size < 0) {
-				array = {}; // XXX use estimated_size
-				int i = 0;
-				spliterator.each(g => {
-					if (i >= MAX_ARRAY_LENGTH) {
-						error("Seq exceeds max array length");
-					} else if (i >= array.length) {
-						int64 next_len = next_pot(i);
-						if (next_len > MAX_ARRAY_LENGTH || next_len < 0) {
-							next_len = (int64)MAX_ARRAY_LENGTH;
-						}
-						array.resize((int) next_len);
-					}
-					array[i++] = g;
-				});
-				if (array.length != i) array.resize(i);
-			} else if (spliterator.estimated_size > 0) {
-				if (spliterator.estimated_size > MAX_ARRAY_LENGTH) {
-					error("Seq exceeds max array length");
-				}
-				array = new G[spliterator.estimated_size];
-				int i = 0;
-				spliterator.each(g => {
-					array[i++] = g;
-				});
-			} else { // spliterator.estimated_size == 0
-				array = {};
-			}
-			return array;
-		}
-
-		/**
-		 * Finds next power of two, which is greater than and not equal to n.
-		 * @return next power of two, which is greater than and not equal to n
-		 */
-		private inline int64 next_pot (int64 n) {
-			n |= n >> 1;
-			n |= n >> 2;
-			n |= n >> 4;
-			n |= n >> 8;
-			n |= n >> 16;
-			n |= n >> 32;
-			return (n > int64.MAX - 1) ? -1 : ++n;
-		}
 	}
 }
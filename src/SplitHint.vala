@@ -0,0 +1,49 @@
+/* SplitHint.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A spliterator that can tell that it should be split further, regardless
+	 * of the threshold and the max depth of the task traversing it.
+	 *
+	 * {@link SpliteratorTask} keeps splitting its spliterator while the
+	 * spliterator implements this interface and reports that it is
+	 * oversized. The containers that neither buffer nor reorder their
+	 * input forward the hint of the input.
+	 */
+	internal interface SplitHint : Object {
+		/**
+		 * Whether or not the spliterator holds too many elements to be
+		 * traversed by one task.
+		 */
+		public abstract bool is_oversized { get; }
+
+		/**
+		 * Gets the hint of the given spliterator.
+		 *
+		 * @return whether or not the spliterator implements this interface
+		 * and is oversized
+		 */
+		public static bool of<G> (Spliterator<G> spliterator) {
+			var hint = spliterator as SplitHint;
+			return hint != null && hint.is_oversized;
+		}
+	}
+}
@@ -99,6 +99,18 @@ namespace Gpseq {
 		 */
 		public abstract bool is_size_known { get; }
 
+		/**
+		 * The characteristics of this spliterator and its elements.
+		 *
+		 * The default implementation reports no characteristics.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public virtual SpliteratorCharacteristics characteristics {
+			get {
+				return 0;
+			}
+		}
+
 		/**
 		 * Applies the given function to each of the remaining elements.
 		 *
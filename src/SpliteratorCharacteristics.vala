@@ -0,0 +1,60 @@
+/* SpliteratorCharacteristics.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * Characteristics of a spliterator and its elements, which can be used to
+	 * skip redundant work in seq pipelines.
+	 *
+	 * A characteristic must hold for all elements the spliterator covers, and
+	 * also for the spliterators split from it.
+	 */
+	[Version (since="0.4.0-alpha")]
+	[Flags]
+	public enum SpliteratorCharacteristics {
+		/**
+		 * Indicates that the elements have a defined encounter order.
+		 */
+		ORDERED,
+		/**
+		 * Indicates that no two elements are equal according to the default
+		 * equal function of the element type, i.e. the result of
+		 * {@link Gee.Functions.get_equal_func_for}.
+		 */
+		DISTINCT,
+		/**
+		 * Indicates that the elements are sorted according to the default
+		 * compare function of the element type, i.e. the result of
+		 * {@link Gee.Functions.get_compare_func_for}. This implies
+		 * {@link ORDERED}.
+		 */
+		SORTED,
+		/**
+		 * Indicates that {@link Spliterator.estimated_size} is the exact,
+		 * finite number of the remaining elements before traversal.
+		 */
+		SIZED,
+		/**
+		 * Indicates that all spliterators split from the spliterator are
+		 * {@link SIZED} as well.
+		 */
+		SUBSIZED
+	}
+}
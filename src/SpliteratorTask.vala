@@ -126,7 +126,7 @@ namespace Gpseq {
 		 *
 		 * When the {@link ForkJoinTask.shared_result} is already ready without
 		 * exceptions, this task has been cancelled, or a class that inherits
-		 * this class needs, the empty result is used and set to the promise of
+		 * this class needs, the empty result is used and set as the result of
 		 * this task.
 		 */
 		protected abstract R empty_result {
@@ -136,33 +136,24 @@ namespace Gpseq {
 		protected override void compute () {
 			if (shared_result.ready) {
 				if (shared_result.error == null) {
-					promise.set_value(empty_result);
+					return_value(empty_result);
 				} else {
-					promise.set_exception(shared_result.error);
+					return_error(shared_result.error);
 				}
 				return;
 			} else if (is_cancelled) {
-				promise.set_value(empty_result);
+				return_value(empty_result);
 				return;
 			}
 
 			int64 size = _spliterator.estimated_size;
-			if (0 <= size <= threshold || 0 <= max_depth <= depth) {
-				try {
-					R result = leaf_compute();
-					set_value((owned) result);
-				} catch (Error err) {
-					set_error((owned) err);
-				}
+			if ((0 <= size <= threshold || 0 <= max_depth <= depth)
+					&& !SplitHint.of<G>(_spliterator)) {
+				compute_leaf();
 			} else {
 				var split = _spliterator.try_split();
 				if (split == null) {
-					try {
-						R result = leaf_compute();
-						set_value((owned) result);
-					} catch (Error err) {
-						set_error((owned) err);
-					}
+					compute_leaf();
 					return;
 				}
 				_left_child = make_child(split); // must before right
@@ -171,12 +162,12 @@ namespace Gpseq {
 
 				try {
 					_right_child.invoke();
-					R result_r = _right_child.future.value;
+					R result_r = _right_child.join();
 					R result_l = _left_child.join();
 
 					if (is_root && shared_result.ready) {
 						_spliterator = null;
-						shared_result.bake_promise(promise);
+						shared_result.bake(this);
 					} else {
 						R result = merge_results((owned) result_l, (owned) result_r);
 						set_value((owned) result);
@@ -190,6 +181,31 @@ namespace Gpseq {
 			}
 		}
 
+		private void compute_leaf () {
+			var observer = executor as LeafObserver;
+			if (observer == null) {
+				try {
+					R result = leaf_compute();
+					set_value((owned) result);
+				} catch (Error err) {
+					set_error((owned) err);
+				}
+				return;
+			}
+
+			// reports before completion, so that the measurement is visible
+			// once the result is
+			int64 size = _spliterator.estimated_size;
+			int64 start = get_monotonic_time();
+			try {
+				R result = leaf_compute();
+				observer.leaf_computed(size, get_monotonic_time() - start);
+				set_value((owned) result);
+			} catch (Error err) {
+				set_error((owned) err);
+			}
+		}
+
 		/**
 		 * Computes this leaf node task.
 		 *
@@ -212,9 +228,9 @@ namespace Gpseq {
 		private void set_value (owned R value) {
 			_spliterator = null;
 			if (is_root && shared_result.ready) {
-				shared_result.bake_promise(promise);
+				shared_result.bake(this);
 			} else {
-				promise.set_value((owned) value);
+				return_value((owned) value);
 			}
 		}
 
@@ -223,7 +239,7 @@ namespace Gpseq {
 			if (!is_root && !shared_result.ready) {
 				shared_result.error = error;
 			}
-			promise.set_exception((owned) error);
+			return_error((owned) error);
 		}
 	}
 }
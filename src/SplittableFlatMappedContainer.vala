@@ -0,0 +1,244 @@
+/* SplittableFlatMappedContainer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/*
+	 * A container which contains the elements of the spliterators produced
+	 * by applying a mapper function to the elements of a input.
+	 *
+	 * Unlike FlatMappedContainer, this container can split inside an inner
+	 * spliterator: if the input can not be split any more, an element is
+	 * taken from the input and mapped, and then the resulting inner
+	 * spliterator is split. So an element that expands to many elements is
+	 * processed in parallel.
+	 *
+	 * The remaining elements are those of the current inner spliterator,
+	 * followed by those of the inner spliterators of the remaining input.
+	 * While any input remains, the size is estimated from the sizes of the
+	 * inner spliterators mapped so far, and is unknown if no element has
+	 * been mapped yet.
+	 *
+	 * An inner spliterator is split down to the threshold resolved for its
+	 * own size, regardless of the threshold and the max depth of the task
+	 * that splits this container; see SplitHint.
+	 */
+	internal class SplittableFlatMappedContainer<R,G> : Object, Spliterator<R>, Container<R,G>, SplitHint {
+		private Spliterator<G> _spliterator; // may be a Container
+		private Container<G,void*>? _parent;
+		private SpliteratorFlatMapFunc<R,G> _mapper;
+		private Spliterator<R>? _inner;
+		private Error? _error; // thrown by the mapper while splitting
+
+		private TaskEnv? _task_env; // null if not parallel
+		private int _parallels;
+		private int64 _inner_origin_size = -1; // the size of the current inner spliterator when mapped
+		private int64 _mapped; // the number of the elements mapped while splitting
+		private int64 _mapped_size; // the sum of the sizes of their inner spliterators
+
+		/**
+		 * Creates a new splittable flat mapped container.
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new container
+		 * @param mapper a //non-interfering// and //stateless// mapping
+		 * function
+		 */
+		public SplittableFlatMappedContainer (Spliterator<G> spliterator, Container<G,void*>? parent,
+				owned SpliteratorFlatMapFunc<R,G> mapper) {
+			_spliterator = spliterator;
+			_parent = parent;
+			_mapper = (owned) mapper;
+		}
+
+		/**
+		 * Creates a container which contains only the given part of the
+		 * inner spliterator of the given container.
+		 */
+		private SplittableFlatMappedContainer.inner_part (
+				SplittableFlatMappedContainer<R,G> origin, Spliterator<R> inner) {
+			_spliterator = Spliterator.empty<G>();
+			_mapper = g => { return origin._mapper(g); };
+			_inner = inner;
+			copy_state(origin);
+		}
+
+		private void copy_state (SplittableFlatMappedContainer<R,G> origin) {
+			_task_env = origin._task_env;
+			_parallels = origin._parallels;
+			_inner_origin_size = origin._inner_origin_size;
+			_mapped = origin._mapped;
+			_mapped_size = origin._mapped_size;
+		}
+
+		public Container<G,void*>? parent {
+			get {
+				return _parent;
+			}
+		}
+
+		public virtual Future<void*> start (Seq seq) {
+			var future = parent != null ? parent.start(seq) : Future.of<void*>(null);
+			_parent = null;
+			if (seq.is_parallel) {
+				_task_env = seq.task_env;
+				_parallels = seq.task_env.executor.parallels;
+			}
+			return future;
+		}
+
+		public Spliterator<R>? try_split () {
+			Spliterator<G>? source = _spliterator.try_split();
+			if (source != null) {
+				// the current inner spliterator precedes the split input
+				var container = new SplittableFlatMappedContainer<R,G>(
+						source, _parent, g => { return _mapper(g); });
+				container._inner = (owned) _inner;
+				container.copy_state(this);
+				_inner_origin_size = -1;
+				return container;
+			}
+
+			if (_error != null) return null;
+			try {
+				if (_inner == null) {
+					if ( !next_inner() ) return null;
+					_inner_origin_size = _inner.estimated_size;
+					if (_inner_origin_size >= 0) {
+						_mapped++;
+						_mapped_size = saturated_add(_mapped_size, _inner_origin_size);
+					}
+				}
+			} catch (Error err) {
+				// deferred to the traversal
+				_error = (owned) err;
+				return null;
+			}
+			Spliterator<R>? split = _inner.try_split();
+			if (split != null) {
+				return new SplittableFlatMappedContainer<R,G>.inner_part(this, split);
+			}
+
+			// the inner spliterator can not be split; hand it over as a whole
+			// if the input remains
+			if (_spliterator.is_size_known && _spliterator.estimated_size == 0) {
+				return null;
+			}
+			Spliterator<R> inner = (owned) _inner;
+			return inner;
+		}
+
+		/**
+		 * Takes an element from the input and maps it to a new inner
+		 * spliterator.
+		 *
+		 * @return false if the input has no remaining element, true otherwise
+		 */
+		private bool next_inner () throws Error {
+			return _spliterator.try_advance(g => {
+				_inner = _mapper(g);
+			});
+		}
+
+		private void check_error () throws Error {
+			if (_error != null) {
+				Error err = (owned) _error;
+				throw err;
+			}
+		}
+
+		public bool try_advance (Func<R> consumer) throws Error {
+			check_error();
+			while (true) {
+				if (_inner != null) {
+					if ( _inner.try_advance(consumer) ) return true;
+					_inner = null;
+				}
+				if ( !next_inner() ) return false;
+			}
+		}
+
+		public int64 estimated_size {
+			get {
+				int64 inner = _inner != null ? _inner.estimated_size : 0;
+				if (inner < 0) return -1;
+				int64 outer = _spliterator.estimated_size;
+				if (outer == 0 && _spliterator.is_size_known) return inner;
+				if (outer < 0 || _mapped == 0) return -1;
+
+				// the remaining input is assumed to expand like the elements
+				// mapped so far
+				int64 average = _mapped_size / _mapped + (_mapped_size % _mapped != 0 ? 1 : 0);
+				if (average != 0 && outer > (int64.MAX - inner) / average) {
+					return int64.MAX;
+				}
+				return inner + outer * average;
+			}
+		}
+
+		private static int64 saturated_add (int64 a, int64 b) {
+			return a > int64.MAX - b ? int64.MAX : a + b;
+		}
+
+		public bool is_size_known {
+			get {
+				return _spliterator.is_size_known && _spliterator.estimated_size == 0
+						&& (_inner == null || _inner.is_size_known);
+			}
+		}
+
+		public bool is_oversized {
+			get {
+				if (_task_env == null || _inner == null || _inner_origin_size < 0) {
+					return false;
+				}
+				int64 threshold = _task_env.resolve_threshold(_inner_origin_size, _parallels);
+				return _inner.estimated_size > threshold;
+			}
+		}
+
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return _spliterator.characteristics & SpliteratorCharacteristics.ORDERED;
+			}
+		}
+
+		public void each (Func<R> f) throws Error {
+			check_error();
+			if (_inner != null) {
+				_inner.each(f);
+				_inner = null;
+			}
+			_spliterator.each(g => {
+				_mapper(g).each(f);
+			});
+		}
+
+		public bool each_chunk (EachChunkFunc<R> f) throws Error {
+			check_error();
+			while (true) {
+				if (_inner != null) {
+					// keeps the inner spliterator if stopped in the middle
+					if ( !_inner.each_chunk(f) ) return false;
+					_inner = null;
+				}
+				if ( !next_inner() ) return true;
+			}
+		}
+	}
+}
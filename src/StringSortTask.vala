@@ -0,0 +1,174 @@
+/* StringSortTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A fork-join task that sorts strings by their bytes, with multikey
+	 * quicksort (three-way radix quicksort).
+	 *
+	 * Each step partitions the strings on the byte at the current depth
+	 * into less, equal, and greater parts; the equal part continues with the
+	 * next byte. The bytes are compared directly, so no compare function is
+	 * called. Parts larger than the threshold are sorted by child tasks.
+	 */
+	internal class StringSortTask : ForkJoinTask<void*> {
+		private const int INSERTION_SORT_THRESHOLD = 16;
+
+		private uint8** _data;
+		private int _start;
+		private int _end;
+		private int _offset; // byte offset; the strings share a prefix before it
+
+		/**
+		 * Creates a new string sort task.
+		 *
+		 * @param data the strings to sort
+		 * @param start zero-based index of the begin
+		 * @param end zero-based index after the end
+		 * @param offset the byte offset to compare from
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public StringSortTask (uint8** data, int start, int end, int offset,
+				StringSortTask? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(parent, threshold, max_depth, executor);
+			_data = data;
+			_start = start;
+			_end = end;
+			_offset = offset;
+		}
+
+		public override void compute () {
+			int len = _end - _start;
+			if (len <= threshold || 0 <= max_depth <= depth) {
+				sort(_data, _start, _end, _offset);
+				return_value(null);
+				return;
+			}
+
+			int lt, gt;
+			uint8 pivot = partition(_data, _start, _end, _offset, out lt, out gt);
+			StringSortTask[] children = {};
+			if (_start < lt) {
+				children += make_child(_start, lt, _offset);
+			}
+			if (pivot != 0 && lt < gt) {
+				children += make_child(lt, gt, _offset + 1);
+			}
+			if (gt < _end) {
+				children += make_child(gt, _end, _offset);
+			}
+			try {
+				for (int i = 1; i < children.length; i++) {
+					children[i].fork();
+				}
+				if (children.length > 0) {
+					children[0].invoke();
+				}
+				for (int i = 1; i < children.length; i++) {
+					children[i].join();
+				}
+				return_value(null);
+			} catch (Error err) {
+				return_error((owned) err);
+			}
+		}
+
+		private StringSortTask make_child (int start, int end, int offset) {
+			var task = new StringSortTask(_data, start, end, offset, this,
+					threshold, max_depth, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+
+		/**
+		 * Sorts the strings in the range sequentially.
+		 */
+		public static void sort (uint8** data, int start, int end, int offset) {
+			while (end - start > INSERTION_SORT_THRESHOLD) {
+				int lt, gt;
+				uint8 pivot = partition(data, start, end, offset, out lt, out gt);
+				sort(data, start, lt, offset);
+				if (pivot != 0) {
+					sort(data, lt, gt, offset + 1);
+				}
+				// the greater part in the loop, to bound the recursion
+				start = gt;
+			}
+			insertion_sort(data, start, end, offset);
+		}
+
+		/**
+		 * Partitions the range on the byte at the offset, around the median
+		 * of three bytes.
+		 *
+		 * After the partition, [start, lt) have smaller bytes, [lt, gt) have
+		 * the pivot byte, and [gt, end) have greater bytes.
+		 *
+		 * @return the pivot byte
+		 */
+		private static uint8 partition (uint8** data, int start, int end, int offset,
+				out int lt, out int gt) {
+			uint8 a = data[start][offset];
+			uint8 b = data[start + ((end - start) >> 1)][offset];
+			uint8 c = data[end - 1][offset];
+			uint8 pivot = a < b ? (b < c ? b : (a < c ? c : a))
+					: (a < c ? a : (b < c ? c : b));
+			lt = start;
+			gt = end;
+			int i = start;
+			while (i < gt) {
+				uint8 v = data[i][offset];
+				if (v < pivot) {
+					swap(data, lt++, i++);
+				} else if (v > pivot) {
+					swap(data, i, --gt);
+				} else {
+					i++;
+				}
+			}
+			return pivot;
+		}
+
+		private static void insertion_sort (uint8** data, int start, int end, int offset) {
+			for (int i = start + 1; i < end; i++) {
+				for (int j = i; j > start && less(data[j], data[j-1], offset); j--) {
+					swap(data, j, j-1);
+				}
+			}
+		}
+
+		private static inline bool less (uint8* a, uint8* b, int offset) {
+			int i = offset;
+			while (a[i] == b[i] && a[i] != 0) i++;
+			return a[i] < b[i];
+		}
+
+		private static inline void swap (uint8** data, int i, int j) {
+			uint8* t = data[i];
+			data[i] = data[j];
+			data[j] = t;
+		}
+	}
+}
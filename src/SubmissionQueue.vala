@@ -0,0 +1,248 @@
+/* SubmissionQueue.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+namespace Gpseq {
+	/**
+	 * A multi-producer, multi-consumer queue for tasks submitted from the
+	 * outside of worker threads.
+	 *
+	 * The queue is split into shards, and a submitter thread offers tasks to
+	 * the shard selected by the hash of the thread. Each shard is a bounded
+	 * lock-free ring; only when a ring is full, the tasks overflow to a
+	 * locked list of the shard, and the following tasks also go to the list
+	 * until it is drained, so a shard is polled in FIFO order. Consumers
+	 * drain the shards in batches, starting at a given shard.
+	 */
+	internal class SubmissionQueue : Object {
+		private const int MAX_SHARDS = 64;
+		private const int SHARD_CAPACITY = 256;
+
+		private Shard[] _shards;
+		private int _size; // AtomicInt
+
+		/**
+		 * Creates a new submission queue.
+		 *
+		 * @param concurrency the estimated number of concurrent submitters
+		 */
+		public SubmissionQueue (int concurrency) {
+			int n = 1;
+			while (n < concurrency && n < MAX_SHARDS) n <<= 1;
+			_shards = new Shard[n];
+			for (int i = 0; i < n; i++) {
+				_shards[i] = new Shard(SHARD_CAPACITY);
+			}
+		}
+
+		/**
+		 * The number of tasks in this queue. This may be inaccurate while
+		 * tasks are being offered or polled concurrently.
+		 */
+		public int size {
+			get {
+				int size = AtomicInt.get(ref _size);
+				return (size < 0) ? 0 : size;
+			}
+		}
+
+		public bool is_empty {
+			get {
+				return AtomicInt.get(ref _size) <= 0;
+			}
+		}
+
+		/**
+		 * Offers a task to the shard of the current thread.
+		 *
+		 * Note. Can be called by any thread
+		 */
+		public void offer (Task task) {
+			_shards[shard_index()].offer(task);
+			AtomicInt.inc(ref _size);
+		}
+
+		/**
+		 * Polls a task from any shard.
+		 *
+		 * Note. Can be called by any thread
+		 *
+		 * @return a task, or null if the queue is empty
+		 */
+		public Task? poll () {
+			for (int i = 0; i < _shards.length; i++) {
+				Task? task = _shards[i].poll();
+				if (task != null) {
+					AtomicInt.add(ref _size, -1);
+					return task;
+				}
+			}
+			return null;
+		}
+
+		/**
+		 * Moves up to //max// tasks to the given work queue, no more than
+		 * its remaining capacity.
+		 *
+		 * Note. Called by the owner thread of the work queue
+		 *
+		 * @param dest the work queue of the current thread
+		 * @param max the maximum number of tasks to move
+		 * @param start a hint of the shard to start draining at
+		 * @return the number of tasks moved
+		 */
+		public int drain_to (WorkQueue dest, int max, uint start) {
+			max = int.min(max, dest.remaining_capacity);
+			int mask = _shards.length - 1;
+			int taken = 0;
+			for (int i = 0; i < _shards.length && taken < max; i++) {
+				Shard shard = _shards[(int) ((start + i) & mask)];
+				while (taken < max) {
+					Task? task = shard.poll();
+					if (task == null) break;
+					// only the current thread adds to dest, and max is within
+					// its remaining capacity
+					bool offered = dest.offer_tail(task);
+					assert(offered);
+					taken++;
+				}
+			}
+			if (taken > 0) AtomicInt.add(ref _size, -taken);
+			return taken;
+		}
+
+		private int shard_index () {
+			if (_shards.length == 1) return 0;
+			size_t addr = (size_t) Thread.self<void*>();
+			uint h = (uint) (addr >> 4) * 0x9E3779B9U;
+			h ^= h >> 16;
+			return (int) (h & (_shards.length - 1));
+		}
+
+		private class Shard {
+			private CacheLinePad _pad0;
+			private Cell[] _buffer;
+			private CacheLinePad _pad1;
+			private uint _enq;
+			private CacheLinePad _pad2;
+			private uint _deq;
+			private CacheLinePad _pad3;
+			private int _overflows; // AtomicInt
+			private Gee.Queue<Task> _overflow; // also used to lock
+
+			public Shard (int capacity) {
+				assert(capacity >= 2);
+				assert((capacity & (capacity - 1)) == 0); // power of 2
+				_buffer = new Cell[capacity];
+				for (int i = 0; i < capacity; ++i) {
+					atomic_uint_set(ref _buffer[i].sequence, i);
+				}
+				_overflow = new ArrayQueue<Task>();
+				_suppress_warnings();
+			}
+
+			~Shard () {
+				for (uint i = 0; i < _buffer.length; ++i) {
+					_buffer[i].data = null;
+				}
+			}
+
+			private void _suppress_warnings () {
+				_pad0 = _pad1 = _pad2 = _pad3;
+			}
+
+			public void offer (Task task) {
+				// while tasks have overflowed, new tasks follow them, so that
+				// the tasks are polled in the order they were offered
+				if (AtomicInt.get(ref _overflows) == 0 && try_offer(task)) return;
+				lock (_overflow) {
+					_overflow.offer(task);
+					AtomicInt.inc(ref _overflows);
+				}
+			}
+
+			public Task? poll () {
+				Task? task = try_poll();
+				if (task == null && AtomicInt.get(ref _overflows) > 0) {
+					lock (_overflow) {
+						task = _overflow.poll();
+						if (task != null) AtomicInt.add(ref _overflows, -1);
+					}
+				}
+				return task;
+			}
+
+			private bool try_offer (Task task) {
+				Cell* cell;
+				uint pos = atomic_uint_get(ref _enq);
+				while (true) {
+					cell = &_buffer[pos & buffer_mask()];
+					uint seq = atomic_uint_get(ref cell->sequence);
+					int diff = (int) (seq - pos);
+					if (diff == 0) {
+						if ( atomic_uint_compare_and_exchange(ref _enq, pos, pos+1) ) {
+							break;
+						}
+					} else if (diff < 0) {
+						return false; // full
+					} else {
+						pos = atomic_uint_get(ref _enq);
+					}
+				}
+				cell->data = task;
+				atomic_uint_set(ref cell->sequence, pos+1);
+				return true;
+			}
+
+			private Task? try_poll () {
+				Cell* cell;
+				uint pos = atomic_uint_get(ref _deq);
+				uint mask = buffer_mask();
+				while (true) {
+					cell = &_buffer[pos & mask];
+					uint seq = atomic_uint_get(ref cell->sequence);
+					int diff = (int) (seq - (pos+1));
+					if (diff == 0) {
+						if ( atomic_uint_compare_and_exchange(ref _deq, pos, pos+1) ) {
+							break;
+						}
+					} else if (diff < 0) {
+						return null; // empty
+					} else {
+						pos = atomic_uint_get(ref _deq);
+					}
+				}
+				Task? task = (owned) cell->data;
+				atomic_uint_set(ref cell->sequence, pos + mask + 1);
+				return task;
+			}
+
+			private inline uint buffer_mask () {
+				return _buffer.length - 1;
+			}
+		}
+
+		private struct Cell {
+			public uint sequence;
+			public Task? data;
+		}
+	}
+}
@@ -30,6 +30,19 @@ namespace Gpseq {
 		 */
 		public abstract Future<G> future { get; }
 
+		/**
+		 * Whether or not this task has been computed.
+		 *
+		 * This is equivalent to ''future.ready'', but implementations may
+		 * avoid creating the future.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public virtual bool is_done {
+			get {
+				return future.ready;
+			}
+		}
+
 		/**
 		 * Computes the task and sets a value or an error to the
 		 * {@link Task.future}.
@@ -41,7 +54,7 @@ namespace Gpseq {
 		 *
 		 * @throws Error an error occurred in the {@link future}
 		 */
-		public void invoke () throws Error {
+		public virtual void invoke () throws Error {
 			compute();
 			Error? err = future.exception;
 			if (err != null) throw err;
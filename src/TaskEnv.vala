@@ -138,6 +138,19 @@ namespace Gpseq {
 			get;
 		}
 
+		/**
+		 * A cancellation token which interrupts the seqs created with this
+		 * task environment. see {@link Seq.with_cancellation}.
+		 *
+		 * The default implementation returns null.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public virtual CancellationToken? cancellation_token {
+			get {
+				return null;
+			}
+		}
+
 		/**
 		 * Calculates the proper threshold.
 		 *
@@ -0,0 +1,35 @@
+/* TaskTraceFunc.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A function that receives the fork/join events of fork-join tasks.
+	 *
+	 * The function is called in the thread that forks or joins the task, so
+	 * it must be thread-safe and should return quickly.
+	 *
+	 * @param event the event
+	 * @param task the task
+	 *
+	 * @see Gpseq.set_task_trace_func
+	 */
+	[Version (since="0.4.0-alpha")]
+	public delegate void TaskTraceFunc (TaskTraceEvent event, Task task);
+}
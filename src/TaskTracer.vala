@@ -0,0 +1,60 @@
+/* TaskTracer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * Holds the task trace function.
+	 *
+	 * The function is wrapped in an immutable object so that a caller can
+	 * take a reference to it and call it without holding the lock. While no
+	 * function is set, tracing costs one atomic read per event.
+	 */
+	internal class TaskTracer : Object {
+		private static int _enabled; // AtomicInt
+		private static TaskTracer? _tracer;
+
+		public static void set_func (owned TaskTraceFunc? func) {
+			bool enabled = func != null;
+			lock (_tracer) {
+				_tracer = enabled ? new TaskTracer((owned) func) : null;
+				AtomicInt.set(ref _enabled, enabled ? 1 : 0);
+			}
+		}
+
+		/**
+		 * Reports the event to the trace function, if set.
+		 */
+		public static inline void trace (TaskTraceEvent event, Task task) {
+			if (AtomicInt.get(ref _enabled) != 0) {
+				TaskTracer? tracer;
+				lock (_tracer) {
+					tracer = _tracer;
+				}
+				if (tracer != null) tracer._func(event, task);
+			}
+		}
+
+		private TaskTraceFunc _func;
+
+		private TaskTracer (owned TaskTraceFunc func) {
+			_func = (owned) func;
+		}
+	}
+}
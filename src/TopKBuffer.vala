@@ -0,0 +1,160 @@
+/* TopKBuffer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A buffer which keeps the //k// least elements offered to it, based on
+	 * a compare function.
+	 *
+	 * The elements are kept in a binary max-heap, so offering an element
+	 * takes O(log k) time. Equal elements are ordered by the order in which
+	 * they were offered, so the result is the same as that of a stable sort
+	 * followed by taking the first //k// elements.
+	 */
+	internal class TopKBuffer<G> : Object {
+		private const int INITIAL_CAPACITY = 16;
+
+		private unowned CompareDataFunc<G> _compare;
+		private int _k;
+		private G[] _items;
+		private int64[] _indices; // offer order; breaks ties
+		private int _size;
+		private int64 _offered;
+
+		/**
+		 * Creates a new top-k buffer.
+		 *
+		 * @param k the maximum number of elements to keep
+		 * @param compare a compare function, which must outlive the buffer
+		 */
+		public TopKBuffer (int k, CompareDataFunc<G> compare)
+			requires (k >= 0)
+		{
+			_compare = compare;
+			_k = k;
+			int capacity = int.min(k, INITIAL_CAPACITY);
+			_items = new G[capacity];
+			_indices = new int64[capacity];
+		}
+
+		/**
+		 * The number of kept elements.
+		 */
+		public int size {
+			get {
+				return _size;
+			}
+		}
+
+		/**
+		 * Offers an element.
+		 */
+		public void offer (G g) {
+			offer_at(g, _offered++);
+		}
+
+		/**
+		 * Offers all the elements kept by the other buffer, as if they were
+		 * offered after the elements offered to this buffer so far.
+		 */
+		public void merge (TopKBuffer<G> other) {
+			for (int i = 0; i < other._size; i++) {
+				offer_at(other._items[i], _offered + other._indices[i]);
+			}
+			_offered += other._offered;
+		}
+
+		/**
+		 * Takes the kept elements in ascending order. This buffer becomes
+		 * empty.
+		 *
+		 * @return the kept elements in ascending order
+		 */
+		public G[] take_sorted () {
+			int len = _size;
+			G[] result = new G[len];
+			for (int i = len - 1; i >= 0; i--) {
+				// the root is the greatest
+				result[i] = (owned) _items[0];
+				_size--;
+				if (_size > 0) {
+					_items[0] = (owned) _items[_size];
+					_indices[0] = _indices[_size];
+					sift_down(0);
+				}
+			}
+			return result;
+		}
+
+		private void offer_at (G g, int64 index) {
+			if (_size < _k) {
+				if (_size == _items.length) grow();
+				_items[_size] = g;
+				_indices[_size] = index;
+				sift_up(_size++);
+			} else if (_k > 0 && less(g, index, _items[0], _indices[0])) {
+				_items[0] = g;
+				_indices[0] = index;
+				sift_down(0);
+			}
+		}
+
+		private void grow () {
+			int capacity = (int) int64.min((int64) _items.length * 2, _k);
+			_items.resize(int.max(capacity, 1));
+			_indices.resize(int.max(capacity, 1));
+		}
+
+		private inline bool less (G a, int64 ia, G b, int64 ib) {
+			int cmp = _compare(a, b);
+			return cmp < 0 || (cmp == 0 && ia < ib);
+		}
+
+		private void sift_up (int i) {
+			while (i > 0) {
+				int p = (i - 1) >> 1;
+				if ( !less(_items[p], _indices[p], _items[i], _indices[i]) ) break;
+				swap(i, p);
+				i = p;
+			}
+		}
+
+		private void sift_down (int i) {
+			while (true) {
+				int l = (i << 1) + 1;
+				if (l >= _size) break;
+				int r = l + 1;
+				int c = (r < _size && less(_items[l], _indices[l], _items[r], _indices[r])) ? r : l;
+				if ( !less(_items[i], _indices[i], _items[c], _indices[c]) ) break;
+				swap(i, c);
+				i = c;
+			}
+		}
+
+		private inline void swap (int i, int j) {
+			G t = (owned) _items[i];
+			_items[i] = (owned) _items[j];
+			_items[j] = (owned) t;
+			int64 ti = _indices[i];
+			_indices[i] = _indices[j];
+			_indices[j] = ti;
+		}
+	}
+}
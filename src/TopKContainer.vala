@@ -0,0 +1,116 @@
+/* TopKContainer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/*
+	 * A container which contains the //k// least elements of a input, sorted
+	 * based on a compare function.
+	 */
+	internal class TopKContainer<G> : DefaultContainer<G> {
+		private CompareDataFunc<G>? _compare;
+		private int _k;
+
+		/**
+		 * Creates a new top-k container.
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new container
+		 * @param compare a //non-interfering// and //stateless// compare
+		 * function
+		 * @param natural whether or not //compare// is the default compare
+		 * function of the element type
+		 * @param k the maximum number of elements
+		 */
+		public TopKContainer (Spliterator<G> spliterator, Container<G,void*> parent,
+				owned CompareDataFunc<G> compare, bool natural, int64 k)
+			requires (k >= 0)
+		{
+			base(spliterator, parent, new Consumer<G>());
+			_compare = (owned) compare;
+			_k = (int) int64.min(k, MAX_ARRAY_LENGTH);
+
+			SpliteratorCharacteristics input = spliterator.characteristics;
+			SpliteratorCharacteristics c = SpliteratorCharacteristics.ORDERED;
+			c |= input & (SpliteratorCharacteristics.DISTINCT | SpliteratorCharacteristics.SIZED);
+			if (SpliteratorCharacteristics.SIZED in input) {
+				c |= SpliteratorCharacteristics.SUBSIZED;
+			}
+			if (natural) c |= SpliteratorCharacteristics.SORTED;
+			set_characteristics(c);
+		}
+
+		private TopKContainer.copy (TopKContainer<G> container, Spliterator<G> spliterator) {
+			base(spliterator, container.parent, container.consumer);
+			_k = container._k;
+		}
+
+		protected override DefaultContainer<G> make_container (Spliterator<G> spliterator) {
+			return new TopKContainer<G>.copy(this, spliterator);
+		}
+
+		public override int64 estimated_size {
+			get {
+				int64 size = spliterator.estimated_size;
+				return size < 0 ? size : int64.min(size, _k);
+			}
+		}
+
+		public override Future<void*> start (Seq seq) {
+			var future = parent != null ? parent.start(seq) : Future.of<void*>(null);
+			set_parent(null);
+			return (Future<void*>) future.flat_map<void*>(value => {
+				try {
+					return select(seq);
+				} catch (Error err) {
+					var promise = new Promise<void*>();
+					promise.set_exception((owned) err);
+					return promise.future;
+				}
+			});
+		}
+
+		private Future<void*> select (Seq seq) throws Error {
+			if (seq.is_parallel) {
+				int64 len = spliterator.estimated_size;
+				int64 threshold = seq.task_env.resolve_threshold(len, seq.task_env.executor.parallels);
+				int max_depth = seq.task_env.resolve_max_depth(len, seq.task_env.executor.parallels);
+				TopKTask<G> task = new TopKTask<G>(
+						_k, _compare, spliterator,
+						null, threshold, max_depth, seq.task_env.executor);
+				task.fork();
+				return (Future<void*>) task.future.map<void*>(value => {
+					set_result(value);
+					return null;
+				});
+			} else {
+				var buffer = new TopKBuffer<G>(_k, _compare);
+				spliterator.each(g => buffer.offer(g));
+				set_result(buffer);
+				return Future.of<void*>(null);
+			}
+		}
+
+		private void set_result (TopKBuffer<G> buffer) {
+			G[] array = buffer.take_sorted();
+			int len = array.length;
+			spliterator = new ArraySpliterator<G>((owned) array, 0, len);
+			_compare = null;
+		}
+	}
+}
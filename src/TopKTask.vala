@@ -0,0 +1,78 @@
+/* TopKTask.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A fork-join task that finds the //k// least elements.
+	 *
+	 * Each leaf keeps a bounded heap, and the heaps are merged in encounter
+	 * order.
+	 */
+	internal class TopKTask<G> : SpliteratorTask<TopKBuffer<G>,G> {
+		private int _k;
+		private unowned CompareDataFunc<G> _compare;
+
+		/**
+		 * Creates a new top-k task.
+		 *
+		 * @param k the number of elements to find
+		 * @param compare a compare function
+		 * @param spliterator a spliterator that may or may not be a container
+		 * @param parent the parent of the new task
+		 * @param threshold sequential computation threshold
+		 * @param max_depth max task split depth. unlimited if negative
+		 * @param executor an executor that will invoke the task
+		 */
+		public TopKTask (int k, CompareDataFunc<G> compare,
+				Spliterator<G> spliterator, TopKTask<G>? parent,
+				int64 threshold, int max_depth, Executor executor)
+		{
+			base(spliterator, parent, threshold, max_depth, executor);
+			_k = k;
+			_compare = compare;
+		}
+
+		protected override TopKBuffer<G> empty_result {
+			owned get {
+				return new TopKBuffer<G>(_k, _compare);
+			}
+		}
+
+		protected override TopKBuffer<G> leaf_compute () throws Error {
+			var buffer = new TopKBuffer<G>(_k, _compare);
+			spliterator.each(g => buffer.offer(g));
+			return buffer;
+		}
+
+		protected override TopKBuffer<G> merge_results (
+				owned TopKBuffer<G> left, owned TopKBuffer<G> right) throws Error {
+			left.merge(right);
+			return left;
+		}
+
+		protected override SpliteratorTask<TopKBuffer<G>,G> make_child (Spliterator<G> spliterator) {
+			var task = new TopKTask<G>(_k, _compare,
+					spliterator, this,
+					threshold, max_depth, executor);
+			task.depth = depth + 1;
+			return task;
+		}
+	}
+}
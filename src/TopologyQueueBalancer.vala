@@ -0,0 +1,86 @@
+/* TopologyQueueBalancer.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A queue balancer that steals tasks from nearby contexts first.
+	 *
+	 * The other contexts are divided into tiers by the distance between their
+	 * CPUs and the CPU of the owner context: siblings that share a core or an
+	 * L2 cache, contexts on the same NUMA node, and remote contexts. The tiers
+	 * are scanned in that order, starting from a random context in each tier.
+	 */
+	internal class TopologyQueueBalancer : DefaultQueueBalancer {
+		private CpuTopology _topology;
+		private int _cpu;
+		private int[]? _victims; // context indices ordered by distance
+		private int[]? _tier_ends;
+
+		/**
+		 * Creates a new topology queue balancer.
+		 *
+		 * @param topology the topology of the CPUs
+		 * @param cpu the CPU of the owner context
+		 */
+		public TopologyQueueBalancer (CpuTopology topology, int cpu) {
+			_topology = topology;
+			_cpu = cpu;
+		}
+
+		protected override bool try_steal (WorkerContext context) {
+			if (_victims == null) build_tiers(context);
+			Gee.List<WorkerContext> contexts = context.pool.contexts;
+			int begin = 0;
+			for (int t = 0; t < _tier_ends.length; t++) {
+				int end = _tier_ends[t];
+				int len = end - begin;
+				if (len > 0) {
+					int start = rand.int_range(0, len);
+					for (int i = 0; i < len; i++) {
+						int idx = _victims[begin + (start + i) % len];
+						if ( steal_from(context, contexts[idx]) ) return true;
+					}
+				}
+				begin = end;
+			}
+			return false;
+		}
+
+		/**
+		 * Sorts the other contexts by distance. This is done lazily since the
+		 * contexts are not complete until all of them have been created.
+		 */
+		private void build_tiers (WorkerContext context) {
+			Gee.List<WorkerContext> contexts = context.pool.contexts;
+			int[] victims = {};
+			int[] tier_ends = new int[CpuTopology.REMOTE + 1];
+			for (int d = CpuTopology.SAME_CPU; d <= CpuTopology.REMOTE; d++) {
+				for (int i = 0; i < contexts.size; i++) {
+					WorkerContext ctx = contexts[i];
+					if (ctx == context) continue;
+					if (_topology.distance(_cpu, ctx.cpu) == d) victims += i;
+				}
+				tier_ends[d] = victims.length;
+			}
+			_victims = victims;
+			_tier_ends = tier_ends;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/* TopologyThreadFactory.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A thread factory that binds each new worker thread to a logical CPU.
+	 *
+	 * The threads are assigned to the CPUs in the order of locality, so that
+	 * the threads created one after another run on the CPUs close to each
+	 * other. A {@link WorkerPool} created with this factory also steals tasks
+	 * from the threads on sibling CPUs first, then from the threads on the
+	 * same NUMA node, and then from the remote threads.
+	 *
+	 * The CPU topology is read from /sys/devices/system/cpu. Binding threads
+	 * is supported only on Linux; on the other platforms the threads are not
+	 * bound, but the stealing order is still used.
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class TopologyThreadFactory : Object, ThreadFactory {
+		private CpuTopology _topology;
+		private int _next_index; // AtomicInt
+
+		/**
+		 * Creates a new topology-aware thread factory.
+		 */
+		public TopologyThreadFactory () {
+			_topology = CpuTopology.get_default();
+		}
+
+		/**
+		 * The topology of the CPUs.
+		 */
+		internal CpuTopology topology {
+			get {
+				return _topology;
+			}
+		}
+
+		/**
+		 * The number of the online logical CPUs.
+		 */
+		public int num_cpus {
+			get {
+				return _topology.num_cpus;
+			}
+		}
+
+		public WorkerThread create_thread (WorkerPool pool) {
+			WorkerThread thread = new WorkerThread(pool);
+			int index = AtomicInt.add(ref _next_index, 1);
+			thread.cpu = _topology.cpu_at(index & int.MAX);
+			return thread;
+		}
+	}
+}
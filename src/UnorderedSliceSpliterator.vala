@@ -91,6 +91,12 @@ namespace Gpseq {
 			}
 		}
 
+		public SpliteratorCharacteristics characteristics {
+			get {
+				return _spliterator.characteristics & SpliteratorCharacteristics.DISTINCT;
+			}
+		}
+
 		/**
 		 * Acquires permission to skip or process elements.
 		 * @param num the number of elements that the caller has in hand
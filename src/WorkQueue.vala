@@ -54,12 +54,27 @@ namespace Gpseq {
 			initial_queue_log_capacity = int.min(TRY_INITIAL_QUEUE_LOG_CAPACITY, max_queue_log_capacity);
 		}
 
-		private CircularArray<Task> _array;
+		private CircularArray _array;
 		private int _head; // AtomicInt
 		private int _tail;
+		private int _max_log_capacity;
 
 		public WorkQueue () {
-			_array = new CircularArray<Task>(initial_queue_log_capacity);
+			_max_log_capacity = max_queue_log_capacity;
+			_array = new CircularArray(initial_queue_log_capacity);
+		}
+
+		/**
+		 * Creates a new work queue whose array does not grow beyond
+		 * //1 << max_log_capacity//, nor beyond the default maximum size.
+		 *
+		 * @param max_log_capacity log₂ of the maximum size of the array
+		 */
+		public WorkQueue.with_max_log_capacity (int max_log_capacity)
+			requires (max_log_capacity >= 2)
+		{
+			_max_log_capacity = int.min(max_log_capacity, max_queue_log_capacity);
+			_array = new CircularArray(int.min(initial_queue_log_capacity, _max_log_capacity));
 		}
 
 		public bool is_empty {
@@ -81,48 +96,72 @@ namespace Gpseq {
 			}
 		}
 
-		private void grow_array (CircularArray<Task> current, int tail, int head) {
-			int new_log_len = current.log_length + 1;
-			if (new_log_len > max_queue_log_capacity) {
-				error( "Queue capacity exceeded: %d > %d",
-						(1 << new_log_len),
-						(1 << max_queue_log_capacity) );
+		/**
+		 * The number of tasks that can be added before the queue reaches its
+		 * maximum capacity.
+		 *
+		 * Note. Called by owner thread
+		 */
+		public int remaining_capacity {
+			get {
+				return (1 << _max_log_capacity) - 1 - size;
 			}
+		}
 
-			CircularArray<Task> new_array = new CircularArray<Task>(new_log_len);
+		/**
+		 * Grows the array until //extra// more tasks fit in it.
+		 *
+		 * Note. Called by owner thread
+		 *
+		 * @return false if the maximum capacity would be exceeded
+		 */
+		private bool ensure_capacity (int head, int tail, int extra) {
+			while (tail - head + extra >= _array.length) {
+				if ( !grow_array(_array, tail, head) ) return false;
+			}
+			return true;
+		}
+
+		private bool grow_array (CircularArray current, int tail, int head) {
+			int new_log_len = current.log_length + 1;
+			if (new_log_len > _max_log_capacity) return false;
+
+			// the tasks are moved as raw pointers; only those not taken by
+			// thieves in the meantime are moved
+			CircularArray new_array = new CircularArray(new_log_len);
 			for (int i = head; i < tail; i++) {
-				Task cmp = current[i];
-				if (compare_and_exchange(current, i, cmp, null)) {
-					new_array[i] = cmp;
-					cmp.unref();
+				Task* task = *current.get_pointer(i);
+				if (task != null && compare_and_exchange(current, i, task, null)) {
+					*new_array.get_pointer(i) = task;
 				}
 			}
 			_array = new_array;
+			return true;
 		}
 
 		/**
+		 * Adds the given task at the tail.
+		 *
 		 * Note. Called by owner thread
+		 *
+		 * @return false if the queue has reached its maximum capacity, true
+		 * otherwise
 		 */
-		public void offer_tail (Task item) {
+		public bool offer_tail (owned Task item) {
 			int old_tail = _tail;
 			int old_head = AtomicInt.get(ref _head);
-			CircularArray<Task> cur_array = _array;
+			if ( !ensure_capacity(old_head, old_tail, 1) ) return false;
 
-			// resize
-			int size = old_tail - old_head;
-			if (size >= cur_array.length-1) {
-				grow_array(cur_array, old_tail, old_head);
-			}
-
-			_array[old_tail] = item;
+			_array[old_tail] = (owned) item;
 			_tail = old_tail + 1;
+			return true;
 		}
 
 		/**
 		 * Note. Called by owner thread
 		 */
 		public Task? poll_tail () {
-			CircularArray<Task> cur_array = _array;
+			unowned CircularArray cur_array = _array; // only replaced by the owner
 			int t = _tail - 1;
 			int old_head = AtomicInt.get(ref _head);
 
@@ -131,13 +170,11 @@ namespace Gpseq {
 				return null;
 			}
 
-			Task* oldval = (Task*) *cur_array.get_pointer(t);
+			Task* oldval = *cur_array.get_pointer(t);
 			if (oldval != null) {
 				if (compare_and_exchange(cur_array, t, oldval, null)) {
 					_tail = t;
-					Task? result = (Task?) oldval;
-					result.unref();
-					return result;
+					return adopt(&oldval);
 				}
 			}
 			return null;
@@ -149,30 +186,86 @@ namespace Gpseq {
 		public Task? poll_head () {
 			int old_head = AtomicInt.get(ref _head); // never decreases
 			int old_tail = _tail;
-			CircularArray<Task> cur_array = _array;
+			CircularArray cur_array = _array;
 
 			int size = old_tail - old_head;
 			if (size <= 0) return null;
 
-			Task* oldval = (Task*) *cur_array.get_pointer(old_head);
+			Task* oldval = *cur_array.get_pointer(old_head);
 			if (oldval != null) {
 				if (compare_and_exchange(cur_array, old_head, oldval, null)) {
 					AtomicInt.set(ref _head, old_head + 1);
-					Task? result = (Task?) oldval;
-					result.unref();
-					return result;
+					return adopt(&oldval);
 				}
 			}
 			return null;
 		}
 
-		private bool compare_and_exchange (CircularArray<Task> array,
+		/**
+		 * Moves up to //max// tasks from the head of this queue to the tail of
+		 * the given queue.
+		 *
+		 * The tasks are taken in a row from the head, and the head is
+		 * advanced once for all of them. The tasks are moved as raw pointers,
+		 * so their reference counts are not touched.
+		 *
+		 * Note. Called by the owner thread of //dest//, which must not be the
+		 * owner thread of this queue
+		 *
+		 * @param dest the work queue of the current thread
+		 * @param max the maximum number of tasks to move
+		 * @return the number of tasks moved
+		 */
+		public int steal_to (WorkQueue dest, int max) {
+			int old_head = AtomicInt.get(ref _head); // never decreases
+			int old_tail = _tail;
+			CircularArray cur_array = _array;
+
+			int n = int.min(old_tail - old_head, max);
+			if (n <= 0) return 0;
+
+			int dest_tail = dest._tail;
+			int dest_head = AtomicInt.get(ref dest._head);
+			if ( !dest.ensure_capacity(dest_head, dest_tail, n) ) {
+				n = int.min(n, dest.remaining_capacity);
+				if (n <= 0) return 0;
+			}
+			unowned CircularArray dest_array = dest._array;
+
+			int taken = 0;
+			while (taken < n) {
+				int idx = old_head + taken;
+				Task* task = *cur_array.get_pointer(idx);
+				// stops at the first task taken by the owner or other thieves
+				if (task == null || !compare_and_exchange(cur_array, idx, task, null)) break;
+				*dest_array.get_pointer(dest_tail + taken) = task;
+				taken++;
+			}
+			if (taken > 0) {
+				AtomicInt.set(ref _head, old_head + taken);
+				dest._tail = dest_tail + taken;
+			}
+			return taken;
+		}
+
+		private bool compare_and_exchange (CircularArray array,
 				int idx, Task* oldval, Task* newval) {
 			return AtomicPointer.compare_and_exchange(array.get_pointer(idx), oldval, newval);
 		}
 
-		private class CircularArray<G> : Object {
-			private G[] _array;
+		/**
+		 * Takes over the reference held by a slot whose task has been taken
+		 * out of the array, without touching the reference count.
+		 */
+		[CCode (cname="g_atomic_pointer_get", cheader_filename = "glib.h")]
+		private static extern Task? adopt ([CCode (type="volatile void *")] Task** task);
+
+		/**
+		 * A circular array of tasks. The array holds a reference to each
+		 * task in it.
+		 */
+		private class CircularArray : Object {
+			private Task?[] _array;
 			private int _log_length;
 
 			/**
@@ -183,7 +276,7 @@ namespace Gpseq {
 			public CircularArray (int log_length)
 					requires (log_length >= 2) // (because of bitwise AND)
 			{
-				_array = new G[1 << log_length];
+				_array = new Task?[1 << log_length];
 				_log_length = log_length;
 			}
 
@@ -199,23 +292,19 @@ namespace Gpseq {
 				}
 			}
 
-			public new G @get (int idx) {
-				// equivalent of '_array[idx % length]' (if length >= 4)
+			public Task** get_pointer (int idx) {
+				// equivalent of '&_array[idx % length]' (if length >= 4)
 				// e.g.
 				// let l is (256 - 1) = 255 = 0xff = 11111111₂
 				// l & 0 = 0
 				// l & 255 = 255
 				// l & 256 = 0
 				// l & 258 = 2
-				return _array[(length-1) & idx];
-			}
-
-			public G** get_pointer (int idx) {
 				return &_array[(length-1) & idx];
 			}
 
-			public new void @set (int idx, G item) {
-				_array[(length-1) & idx] = item;
+			public new void @set (int idx, owned Task item) {
+				_array[(length-1) & idx] = (owned) item;
 			}
 		}
 	}
@@ -26,11 +26,23 @@ namespace Gpseq {
 		private unowned WorkerThread? _thread;
 		private WorkQueue _work_queue;
 		private QueueBalancer _balancer;
+		private Parker _parker;
+		private WorkerCounters _counters;
+		private int _cpu;
+		private int _idle; // AtomicInt
 
-		public WorkerContext (WorkerPool pool) {
+		public WorkerContext (WorkerPool pool, int cpu = -1) {
 			_pool = pool;
+			_cpu = cpu;
 			_work_queue = new WorkQueue();
-			_balancer = new DefaultQueueBalancer();
+			_parker = new Parker();
+			_counters = new WorkerCounters();
+			CpuTopology? topology = pool.topology;
+			if (topology != null && cpu >= 0) {
+				_balancer = new TopologyQueueBalancer(topology, cpu);
+			} else {
+				_balancer = new DefaultQueueBalancer();
+			}
 		}
 
 		public WorkerPool pool {
@@ -39,6 +51,16 @@ namespace Gpseq {
 			}
 		}
 
+		/**
+		 * The logical CPU of the thread that has created this context, or -1
+		 * if the thread is not bound to any CPU.
+		 */
+		public int cpu {
+			get {
+				return _cpu;
+			}
+		}
+
 		public WorkerThread? thread {
 			get {
 				lock (_thread) {
@@ -78,5 +100,51 @@ namespace Gpseq {
 				return _balancer;
 			}
 		}
+
+		/**
+		 * The parker used to park the thread of this context when idle.
+		 */
+		internal Parker parker {
+			get {
+				return _parker;
+			}
+		}
+
+		/**
+		 * The scheduler event counters of this context. They are updated only
+		 * while {@link WorkerPool.stats_enabled} is true.
+		 */
+		internal WorkerCounters counters {
+			get {
+				return _counters;
+			}
+		}
+
+		/**
+		 * Whether or not the thread of this context is parked, or is about to
+		 * be parked.
+		 */
+		internal bool is_idle {
+			get {
+				return AtomicInt.get(ref _idle) != 0;
+			}
+		}
+
+		/**
+		 * Marks this context as idle.
+		 */
+		internal void set_idle () {
+			AtomicInt.set(ref _idle, 1);
+		}
+
+		/**
+		 * Clears the idle mark of this context.
+		 *
+		 * @return true if this call has cleared the mark, false if the context
+		 * was not idle
+		 */
+		internal bool try_clear_idle () {
+			return AtomicInt.compare_and_exchange(ref _idle, 1, 0);
+		}
 	}
 }
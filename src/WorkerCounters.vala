@@ -0,0 +1,157 @@
+/* WorkerCounters.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * Scheduler event counters of a worker context.
+	 *
+	 * The counters are written by the thread of the owner context, and read
+	 * by any thread. They are padded so that the counters of different
+	 * contexts are not placed on the same cache line.
+	 */
+	internal class WorkerCounters : Object {
+		private CacheLinePad _pad0;
+		private int64 _executed; // AtomicInt64
+		private int64 _task_time; // AtomicInt64
+		private int64 _steals; // AtomicInt64
+		private int64 _stolen; // AtomicInt64
+		private int64 _failed_steals; // AtomicInt64
+		private int64 _drains; // AtomicInt64
+		private int64 _drained; // AtomicInt64
+		private int64 _parks; // AtomicInt64
+		private int64 _compensations; // AtomicInt64
+		private int64 _spare_reuses; // AtomicInt64
+		private int64 _rejected_compensations; // AtomicInt64
+		private CacheLinePad _pad1;
+
+		public WorkerCounters () {
+			_suppress_warnings();
+		}
+
+		/**
+		 * Records that a task has been executed in the given time.
+		 *
+		 * @param elapsed the execution time in microseconds
+		 */
+		public void task_executed (int64 elapsed) {
+			atomic_int64_inc(ref _executed);
+			atomic_int64_add(ref _task_time, elapsed);
+		}
+
+		/**
+		 * Records that the given number of tasks have been stolen at once.
+		 */
+		public void tasks_stolen (int64 tasks) {
+			atomic_int64_inc(ref _steals);
+			atomic_int64_add(ref _stolen, tasks);
+		}
+
+		/**
+		 * Records that a scan has found no task to steal.
+		 */
+		public void steal_failed () {
+			atomic_int64_inc(ref _failed_steals);
+		}
+
+		/**
+		 * Records that the given number of tasks have been drained from the
+		 * submission queue at once.
+		 */
+		public void submissions_drained (int64 tasks) {
+			atomic_int64_inc(ref _drains);
+			atomic_int64_add(ref _drained, tasks);
+		}
+
+		/**
+		 * Records that the thread has been parked.
+		 */
+		public void parked () {
+			atomic_int64_inc(ref _parks);
+		}
+
+		/**
+		 * Records that a new thread has been spawned to compensate for a
+		 * blocked thread.
+		 */
+		public void compensated () {
+			atomic_int64_inc(ref _compensations);
+		}
+
+		/**
+		 * Records that a spare thread has been reused to compensate for a
+		 * blocked thread.
+		 */
+		public void spare_reused () {
+			atomic_int64_inc(ref _compensations);
+			atomic_int64_inc(ref _spare_reuses);
+		}
+
+		/**
+		 * Records that a blocked thread has not been compensated since the
+		 * compensation cap has been reached.
+		 */
+		public void compensation_rejected () {
+			atomic_int64_inc(ref _rejected_compensations);
+		}
+
+		/**
+		 * Creates a snapshot of the counters.
+		 *
+		 * @param queued the number of the tasks currently queued
+		 */
+		public WorkerStats snapshot (int64 queued) {
+			var stats = new WorkerStats();
+			stats.tasks_executed = atomic_int64_get(ref _executed);
+			stats.task_time = atomic_int64_get(ref _task_time);
+			stats.steals = atomic_int64_get(ref _steals);
+			stats.stolen_tasks = atomic_int64_get(ref _stolen);
+			stats.failed_steals = atomic_int64_get(ref _failed_steals);
+			stats.drains = atomic_int64_get(ref _drains);
+			stats.drained_tasks = atomic_int64_get(ref _drained);
+			stats.parks = atomic_int64_get(ref _parks);
+			stats.compensations = atomic_int64_get(ref _compensations);
+			stats.spare_reuses = atomic_int64_get(ref _spare_reuses);
+			stats.rejected_compensations = atomic_int64_get(ref _rejected_compensations);
+			stats.queued_tasks = queued;
+			return stats;
+		}
+
+		/**
+		 * Resets the counters to zero.
+		 */
+		public void reset () {
+			atomic_int64_set(ref _executed, 0);
+			atomic_int64_set(ref _task_time, 0);
+			atomic_int64_set(ref _steals, 0);
+			atomic_int64_set(ref _stolen, 0);
+			atomic_int64_set(ref _failed_steals, 0);
+			atomic_int64_set(ref _drains, 0);
+			atomic_int64_set(ref _drained, 0);
+			atomic_int64_set(ref _parks, 0);
+			atomic_int64_set(ref _compensations, 0);
+			atomic_int64_set(ref _spare_reuses, 0);
+			atomic_int64_set(ref _rejected_compensations, 0);
+		}
+
+		private void _suppress_warnings () {
+			_pad0 = _pad1;
+		}
+	}
+}
@@ -26,6 +26,12 @@ namespace Gpseq {
 	 */
 	public class WorkerPool : Object, Executor {
 		private const int DEFAULT_MAX_THREADS = 8192;
+		private const int DEFAULT_MAX_COMPENSATIONS = 256;
+		/**
+		 * The maximum time for which an idle thread is parked at once, in
+		 * microseconds. This bounds the latency of a missed wakeup.
+		 */
+		private const int64 PARK_TIMEOUT = 1000000;
 
 		private static ThreadFactory? default_factory = null;
 
@@ -55,22 +61,31 @@ namespace Gpseq {
 			}
 		}
 
-		private WorkQueue _submission_queue; // also used to lock
+		private SubmissionQueue _submission_queue;
+		private SubmissionQueue _urgent_queue; // TaskPriority.HIGH
+		private SubmissionQueue _background_queue; // TaskPriority.LOW
 
 		private int _max_threads;
 		private int _num_threads; // masters + slaves
 		private ThreadFactory _factory;
+		private CpuTopology? _topology;
 		private Gee.List<WorkerContext> _contexts;
 		private Gee.List<WorkerThread> _threads; // master threads
 		private Gee.Set<WorkerThread> _slaves;
+		private Gee.Deque<WorkerThread> _spares; // parked slaves; LIFO
+
+		private int _max_compensations; // AtomicInt
+		private int _compensations; // AtomicInt; the number of blocked threads compensated
+		private int _max_spares; // AtomicInt
 
 		private int _max_seekers;
 		private int _seekers; // AtomicInt
 
 		private string _thread_name_prefix;
 		private int _next_thread_id; // AtomicInt
-		private Mutex _lock = Mutex();
-		private Cond _cond = Cond(); // used to activate/deactivate threads
+		private int _idles; // AtomicInt; the number of idle contexts
+		private int _next_wake; // AtomicInt; where to start finding an idle context
+		private int _stats_enabled; // AtomicInt
 
 		/**
 		 * * > 0 if terminate() has been called and the pool has not yet been terminated
@@ -94,9 +109,31 @@ namespace Gpseq {
 			this( (int) processors, get_default_factory() );
 		}
 
+		/**
+		 * Creates a new topology-aware worker pool, with default settings.
+		 *
+		 * This is equivalent to {@link WorkerPool.with_defaults} except that
+		 * the pool uses a {@link TopologyThreadFactory}. So the threads are
+		 * bound to CPUs, and tasks are stolen from nearby threads first.
+		 *
+		 * @throws Error if threads can not be created, due to resource limits,
+		 * etc.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public WorkerPool.with_topology () throws Error
+		{
+			uint processors = GLib.get_num_processors();
+			processors = uint.max(processors, processors * 2);
+			processors = uint.min(int.MAX, processors);
+			this( (int) processors, new TopologyThreadFactory() );
+		}
+
 		/**
 		 * Creates a new worker pool.
 		 *
+		 * If the factory is a {@link TopologyThreadFactory}, the threads of
+		 * the pool steal tasks from nearby threads first.
+		 *
 		 * @param parallels the number of threads
 		 * @param factory a thread factory to create new threads
 		 *
@@ -108,10 +145,18 @@ namespace Gpseq {
 		{
 			_max_threads = int.max(parallels, DEFAULT_MAX_THREADS);
 			_factory = factory;
+			TopologyThreadFactory? topology_factory = factory as TopologyThreadFactory;
+			_topology = topology_factory != null ? topology_factory.topology : null;
 			_contexts = new ArrayList<WorkerContext>();
 			_threads = new ArrayList<WorkerThread>();
 			_slaves = new HashSet<WorkerThread>();
-			_submission_queue = new WorkQueue();
+			_spares = new LinkedList<WorkerThread>();
+			_max_compensations = int.max(parallels, DEFAULT_MAX_COMPENSATIONS);
+			_max_spares = parallels;
+			_submission_queue = new SubmissionQueue( (int) GLib.get_num_processors() );
+			int lane_concurrency = (int) uint.max(GLib.get_num_processors() / 4, 1);
+			_urgent_queue = new SubmissionQueue(lane_concurrency);
+			_background_queue = new SubmissionQueue(lane_concurrency);
 			_max_seekers = int.max(parallels/2, 2);
 
 			var sb = new StringBuilder("GpseqWorkerPool-");
@@ -130,8 +175,8 @@ namespace Gpseq {
 		private void init_threads (int n) throws Error {
 			_num_threads = n;
 			for (int i = 0; i < n; i++) {
-				WorkerContext ctx = new WorkerContext(this);
 				WorkerThread t = new_thread();
+				WorkerContext ctx = new WorkerContext(this, t.cpu);
 				t.context = ctx;
 				ctx.thread = t;
 				_contexts.add(ctx);
@@ -187,6 +232,71 @@ namespace Gpseq {
 			}
 		}
 
+		/**
+		 * The maximum number of threads that can compensate for blocked
+		 * threads at the same time.
+		 *
+		 * When a task calls {@link Gpseq.blocking} and this limit has been
+		 * reached, the blocking function runs without compensation, i.e. the
+		 * worker thread is simply blocked. This bounds the number of threads
+		 * created by a burst of blocking calls.
+		 *
+		 * The default value is max(//parallels//, 256).
+		 */
+		[Version (since="0.4.0-alpha")]
+		public int max_compensations {
+			get {
+				return AtomicInt.get(ref _max_compensations);
+			}
+			set {
+				assert(value >= 0);
+				AtomicInt.set(ref _max_compensations, value);
+			}
+		}
+
+		/**
+		 * The current number of threads compensating for blocked threads.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public int num_compensations {
+			get {
+				return AtomicInt.get(ref _compensations);
+			}
+		}
+
+		/**
+		 * The maximum number of spare threads kept in this pool.
+		 *
+		 * A thread that has compensated for a blocked thread is parked as a
+		 * spare thread when the blocked thread is unblocked, and is reused by
+		 * the next compensation. A spare thread that has not been reused for
+		 * a while is terminated.
+		 *
+		 * The default value is {@link parallels}.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public int max_spare_threads {
+			get {
+				return AtomicInt.get(ref _max_spares);
+			}
+			set {
+				assert(value >= 0);
+				AtomicInt.set(ref _max_spares, value);
+			}
+		}
+
+		/**
+		 * The current number of spare threads.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public int num_spare_threads {
+			get {
+				lock (_spares) {
+					return _spares.size;
+				}
+			}
+		}
+
 		/**
 		 * The thread factory to create new threads.
 		 */
@@ -194,6 +304,16 @@ namespace Gpseq {
 			get { return _factory; }
 		}
 
+		/**
+		 * The CPU topology used for stealing tasks, or null if this pool is
+		 * not topology-aware.
+		 */
+		internal CpuTopology? topology {
+			get {
+				return _topology;
+			}
+		}
+
 		/**
 		 * A read-only view of the contexts in this pool.
 		 */
@@ -217,10 +337,102 @@ namespace Gpseq {
 		 * The submission queue. when a task is submitted from the outside of
 		 * worker threads, the task is queued in this queue.
 		 */
-		internal WorkQueue submission_queue {
+		internal SubmissionQueue submission_queue {
 			get { return _submission_queue; }
 		}
 
+		/**
+		 * The queue of the tasks submitted with {@link TaskPriority.HIGH}.
+		 */
+		internal SubmissionQueue urgent_queue {
+			get { return _urgent_queue; }
+		}
+
+		/**
+		 * The queue of the tasks submitted with {@link TaskPriority.LOW}.
+		 */
+		internal SubmissionQueue background_queue {
+			get { return _background_queue; }
+		}
+
+		/**
+		 * Creates a new lane, which submits tasks to this pool with the given
+		 * priority.
+		 *
+		 * @param name the name of the lane, for diagnostics
+		 * @param priority the priority of the tasks submitted through the lane
+		 * @return a new lane
+		 */
+		[Version (since="0.4.0-alpha")]
+		public WorkerPoolLane create_lane (string name, TaskPriority priority) {
+			return new WorkerPoolLane(this, name, priority);
+		}
+
+		/**
+		 * Whether or not scheduler statistics are collected.
+		 *
+		 * Statistics are disabled by default. While disabled, the scheduler
+		 * only checks this flag at each event; while enabled, each worker
+		 * updates its own counters, and the execution time of each task is
+		 * measured.
+		 *
+		 * @see get_stats
+		 * @see get_worker_stats
+		 */
+		[Version (since="0.4.0-alpha")]
+		public bool stats_enabled {
+			get {
+				return AtomicInt.get(ref _stats_enabled) != 0;
+			}
+			set {
+				AtomicInt.set(ref _stats_enabled, value ? 1 : 0);
+			}
+		}
+
+		/**
+		 * Takes a snapshot of the scheduler statistics of this pool, summed
+		 * over all the workers.
+		 *
+		 * The counters of the workers are read one by one while they may be
+		 * updated, so the snapshot is not atomic as a whole.
+		 *
+		 * @return a snapshot of the statistics
+		 */
+		[Version (since="0.4.0-alpha")]
+		public WorkerStats get_stats () {
+			var stats = new WorkerStats();
+			foreach (WorkerContext ctx in _contexts) {
+				stats.add( ctx.counters.snapshot(ctx.work_queue.size) );
+			}
+			stats.queued_tasks += _submission_queue.size;
+			return stats;
+		}
+
+		/**
+		 * Takes snapshots of the scheduler statistics of each worker of this
+		 * pool, which can be used to diagnose load imbalance.
+		 *
+		 * @return a list of snapshots, one per worker
+		 */
+		[Version (since="0.4.0-alpha")]
+		public Gee.List<WorkerStats> get_worker_stats () {
+			var list = new ArrayList<WorkerStats>();
+			foreach (WorkerContext ctx in _contexts) {
+				list.add( ctx.counters.snapshot(ctx.work_queue.size) );
+			}
+			return list;
+		}
+
+		/**
+		 * Resets the scheduler statistics of this pool to zero.
+		 */
+		[Version (since="0.4.0-alpha")]
+		public void reset_stats () {
+			foreach (WorkerContext ctx in _contexts) {
+				ctx.counters.reset();
+			}
+		}
+
 		/**
 		 * Submits a task.
 		 *
@@ -241,7 +453,8 @@ namespace Gpseq {
 			if (thread != null && thread.pool == this) {
 				ctx = thread.context;
 				if (ctx != null) {
-					ctx.work_queue.offer_tail(task);
+					// the work queue is full only in pathological cases
+					if ( !ctx.work_queue.offer_tail(task) ) add_submission(task);
 				} else {
 					add_submission(task);
 				}
@@ -251,37 +464,117 @@ namespace Gpseq {
 			signal_new_task(true);
 		}
 
+		/**
+		 * Submits a task with the given priority.
+		 *
+		 * Tasks submitted in a worker thread of this pool, e.g. the subtasks
+		 * forked by a task, and tasks of {@link TaskPriority.NORMAL} are
+		 * submitted as by {@link submit}. The others are queued in the queue
+		 * of their priority.
+		 */
+		internal void submit_with_priority (Task task, TaskPriority priority) {
+			WorkerThread? thread = WorkerThread.self();
+			if (thread != null && thread.pool == this && thread.context != null) {
+				submit(task);
+				return;
+			}
+			switch (priority) {
+			case TaskPriority.HIGH:
+				if (is_terminating_started) return;
+				_urgent_queue.offer(task);
+				signal_new_task(false);
+				break;
+			case TaskPriority.LOW:
+				if (is_terminating_started) return;
+				_background_queue.offer(task);
+				signal_new_task(true);
+				break;
+			default:
+				submit(task);
+				break;
+			}
+		}
+
+		/**
+		 * Polls a task submitted with {@link TaskPriority.HIGH}, if any.
+		 *
+		 * Worker threads call this between tasks, so this must be cheap when
+		 * no such task is queued.
+		 */
+		internal inline Task? poll_urgent () {
+			if (_urgent_queue.is_empty) return null;
+			return _urgent_queue.poll();
+		}
+
 		/**
 		 * Submits a task to the submission queue of this pool.
 		 *
 		 * @param task a task to submit
 		 */
 		private void add_submission (Task task) {
-			lock (_submission_queue) {
-				_submission_queue.offer_tail(task);
-			}
+			_submission_queue.offer(task);
 		}
 
 		/**
-		 * Wakes one or more threads up.
+		 * Wakes an idle thread up, if any.
+		 *
+		 * Only the thread of one idle context is unparked, so a submission does
+		 * not wake every sleeping thread up.
+		 *
+		 * @param check_seekers if true, does nothing while some threads are
+		 * seeking tasks
 		 */
 		internal void signal_new_task (bool check_seekers) {
-			if (!check_seekers || 0 == AtomicInt.get(ref _seekers)) {
-				_lock.lock();
-				_cond.signal();
-				_lock.unlock();
+			if (check_seekers && 0 != AtomicInt.get(ref _seekers)) return;
+			if (0 == AtomicInt.get(ref _idles)) return;
+			int size = _contexts.size;
+			int start = AtomicInt.add(ref _next_wake, 1) & int.MAX;
+			for (int i = 0; i < size; i++) {
+				WorkerContext ctx = _contexts[(start + i) % size];
+				if ( ctx.try_clear_idle() ) {
+					AtomicInt.add(ref _idles, -1);
+					ctx.parker.unpark();
+					return;
+				}
 			}
 		}
 
 		/**
-		 * Deactivates the given thread.
+		 * Parks the thread of the given context until a new task is signaled,
+		 * the pool starts terminating, or a timeout elapses.
 		 *
-		 * @param t a thread to deactivate
+		 * The context is marked as idle before pending tasks are rechecked, so
+		 * a task submitted concurrently either is found by the recheck or
+		 * unparks the thread.
+		 *
+		 * @param ctx the context of the current thread
+		 * @return true if unparked by another thread, false otherwise
+		 */
+		internal bool park_idle (WorkerContext ctx) {
+			if (stats_enabled) ctx.counters.parked();
+			ctx.set_idle();
+			AtomicInt.add(ref _idles, 1);
+			bool unparked = false;
+			if ( !is_terminating_started && !has_pending_tasks() ) {
+				int64 end = get_monotonic_time() + PARK_TIMEOUT;
+				unparked = ctx.parker.park_until(end);
+			}
+			if ( ctx.try_clear_idle() ) {
+				AtomicInt.add(ref _idles, -1);
+			}
+			return unparked;
+		}
+
+		/**
+		 * Whether or not any task is queued in this pool.
 		 */
-		internal void block_idle (WorkerThread t) {
-			_lock.lock();
-			_cond.wait(_lock);
-			_lock.unlock();
+		private bool has_pending_tasks () {
+			if (_submission_queue.size > 0) return true;
+			if (_urgent_queue.size > 0 || _background_queue.size > 0) return true;
+			foreach (WorkerContext ctx in _contexts) {
+				if (ctx.work_queue.size > 0) return true;
+			}
+			return false;
 		}
 
 		internal void begin_seeking () {
@@ -314,6 +607,7 @@ namespace Gpseq {
 			lock (_slaves) {
 				_slaves.remove(thread);
 			}
+			remove_spare(thread);
 			while (true) {
 				int terminating = AtomicInt.get(ref _terminating);
 				if (terminating <= 0) break;
@@ -373,9 +667,14 @@ namespace Gpseq {
 		 */
 		private void terminate_n (int num) {
 			if ( AtomicInt.compare_and_exchange(ref _terminating, -1, num) ) {
-				_lock.lock();
-				_cond.broadcast();
-				_lock.unlock();
+				foreach (WorkerContext ctx in _contexts) {
+					ctx.parker.unpark();
+				}
+				lock (_spares) {
+					foreach (WorkerThread t in _spares) {
+						t.resume();
+					}
+				}
 			}
 		}
 
@@ -423,6 +722,59 @@ namespace Gpseq {
 			}
 		}
 
+		internal bool try_begin_compensation () {
+			while (true) {
+				int num = AtomicInt.get(ref _compensations);
+				if (num >= max_compensations) return false;
+				if ( AtomicInt.compare_and_exchange(ref _compensations, num, num+1) ) {
+					return true;
+				}
+			}
+		}
+
+		internal void end_compensation () {
+			AtomicInt.add(ref _compensations, -1);
+		}
+
+		/**
+		 * Takes the most recently parked spare thread.
+		 *
+		 * @return a spare thread, or null if none or this pool has been
+		 * terminating
+		 */
+		internal WorkerThread? take_spare () {
+			lock (_spares) {
+				if (is_terminating_started) return null;
+				return _spares.poll_tail();
+			}
+		}
+
+		/**
+		 * Adds the given thread to the spare threads.
+		 *
+		 * @return false if this pool has enough spare threads or has been
+		 * terminating, true otherwise
+		 */
+		internal bool offer_spare (WorkerThread thread) {
+			lock (_spares) {
+				if (is_terminating_started || _spares.size >= max_spare_threads) {
+					return false;
+				}
+				return _spares.offer_tail(thread);
+			}
+		}
+
+		/**
+		 * Removes the given thread from the spare threads.
+		 *
+		 * @return true if removed, false if the thread was not a spare thread
+		 */
+		internal bool remove_spare (WorkerThread thread) {
+			lock (_spares) {
+				return _spares.remove(thread);
+			}
+		}
+
 		internal void add_slave (WorkerThread thread) {
 			lock (_slaves) {
 				bool changed = _slaves.add(thread);
@@ -0,0 +1,86 @@
+/* WorkerPoolLane.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A named executor that submits tasks to a {@link WorkerPool} with a
+	 * priority.
+	 *
+	 * Lanes let workloads of different latency requirements share one pool
+	 * without a batch job starving short requests: e.g. a task env for
+	 * interactive requests can use a {@link TaskPriority.HIGH} lane, and one
+	 * for batch seqs a {@link TaskPriority.LOW} lane.
+	 *
+	 * The priority applies to the tasks submitted through the lane. The
+	 * subtasks forked by those tasks in worker threads are queued in the
+	 * work queues of the threads, as usual.
+	 *
+	 * @see WorkerPool.create_lane
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class WorkerPoolLane : Object, Executor {
+		private WorkerPool _pool;
+		private string _name;
+		private TaskPriority _priority;
+
+		internal WorkerPoolLane (WorkerPool pool, string name, TaskPriority priority) {
+			_pool = pool;
+			_name = name;
+			_priority = priority;
+		}
+
+		/**
+		 * The pool to which this lane submits tasks.
+		 */
+		public WorkerPool pool {
+			get {
+				return _pool;
+			}
+		}
+
+		/**
+		 * The name of this lane.
+		 */
+		public string name {
+			get {
+				return _name;
+			}
+		}
+
+		/**
+		 * The priority of the tasks submitted through this lane.
+		 */
+		public TaskPriority priority {
+			get {
+				return _priority;
+			}
+		}
+
+		public void submit (Task task) {
+			_pool.submit_with_priority(task, _priority);
+		}
+
+		public int parallels {
+			get {
+				return _pool.parallels;
+			}
+		}
+	}
+}
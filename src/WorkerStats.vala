@@ -0,0 +1,130 @@
+/* WorkerStats.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+namespace Gpseq {
+	/**
+	 * A snapshot of the scheduler statistics of a worker pool, or of one of
+	 * its workers.
+	 *
+	 * The statistics are collected only while
+	 * {@link WorkerPool.stats_enabled} is true.
+	 *
+	 * @see WorkerPool.get_stats
+	 * @see WorkerPool.get_worker_stats
+	 */
+	[Version (since="0.4.0-alpha")]
+	public class WorkerStats : Object {
+		internal WorkerStats () {
+		}
+
+		/**
+		 * The number of the tasks executed.
+		 */
+		public int64 tasks_executed { get; internal set; }
+
+		/**
+		 * The total execution time of the executed tasks, in microseconds.
+		 *
+		 * The time of a task includes the time of the subtasks executed
+		 * while joining them.
+		 */
+		public int64 task_time { get; internal set; }
+
+		/**
+		 * The mean execution time of the executed tasks, in microseconds, or
+		 * 0 if no task has been executed.
+		 */
+		public double mean_task_time {
+			get {
+				return tasks_executed > 0 ? (double) task_time / tasks_executed : 0;
+			}
+		}
+
+		/**
+		 * The number of the successful steals.
+		 */
+		public int64 steals { get; internal set; }
+
+		/**
+		 * The number of the tasks taken by the successful steals.
+		 */
+		public int64 stolen_tasks { get; internal set; }
+
+		/**
+		 * The number of the steal scans that found no task.
+		 */
+		public int64 failed_steals { get; internal set; }
+
+		/**
+		 * The number of the times tasks have been drained from the
+		 * submission queue.
+		 */
+		public int64 drains { get; internal set; }
+
+		/**
+		 * The number of the tasks drained from the submission queue.
+		 */
+		public int64 drained_tasks { get; internal set; }
+
+		/**
+		 * The number of the times an idle thread has been parked.
+		 */
+		public int64 parks { get; internal set; }
+
+		/**
+		 * The number of the times a thread blocked in {@link Gpseq.blocking}
+		 * has been compensated, either by a new thread or by a spare thread.
+		 */
+		public int64 compensations { get; internal set; }
+
+		/**
+		 * The number of the compensations done by reusing spare threads.
+		 */
+		public int64 spare_reuses { get; internal set; }
+
+		/**
+		 * The number of the blocking calls that have not been compensated
+		 * since {@link WorkerPool.max_compensations} had been reached.
+		 */
+		public int64 rejected_compensations { get; internal set; }
+
+		/**
+		 * The number of the tasks queued at the time of the snapshot.
+		 *
+		 * For a pool, this includes the tasks in the submission queue.
+		 */
+		public int64 queued_tasks { get; internal set; }
+
+		internal void add (WorkerStats other) {
+			tasks_executed += other.tasks_executed;
+			task_time += other.task_time;
+			steals += other.steals;
+			stolen_tasks += other.stolen_tasks;
+			failed_steals += other.failed_steals;
+			drains += other.drains;
+			drained_tasks += other.drained_tasks;
+			parks += other.parks;
+			compensations += other.compensations;
+			spare_reuses += other.spare_reuses;
+			rejected_compensations += other.rejected_compensations;
+			queued_tasks += other.queued_tasks;
+		}
+	}
+}
@@ -26,9 +26,16 @@ namespace Gpseq {
 	 */
 	public class WorkerThread : Object {
 		private const int MAX_THREAD_IDLE_ITERATIONS = 4;
+		private const int SPINS_MIN = 1;
+		private const int SPINS_MAX = 64;
 		private const int CHECK_INTERVAL_INITIAL = 0;
 		private const int CHECK_INTERVAL_INCR = 1;
 		private const int CHECK_INTERVAL_MAX = 16;
+		/**
+		 * The maximum time for which a spare thread waits to be reused, in
+		 * microseconds.
+		 */
+		private const int64 SPARE_KEEP_ALIVE = 30000000;
 
 		/**
 		 * A table storing worker threads.
@@ -98,12 +105,15 @@ namespace Gpseq {
 		private unowned WorkerThread? _parent = null;
 		private bool _blocked;
 		private bool _seeking;
+		private int _spins = SPINS_MIN;
+		private Parker _spare_parker = new Parker();
 
 		private Thread<void*>? _thread = null; // also used to lock
 		private unowned WorkerPool _pool;
 		private WorkerContext _context;
 		private string _name;
 		private bool _terminated;
+		private int _cpu = -1;
 
 		/**
 		 * Creates a new worker thread.
@@ -123,6 +133,7 @@ namespace Gpseq {
 		internal WorkerThread.slave (WorkerThread parent) {
 			this(parent.pool);
 			_parent = parent;
+			_cpu = parent._cpu;
 			move_context(parent, this);
 		}
 
@@ -201,6 +212,23 @@ namespace Gpseq {
 			}
 		}
 
+		/**
+		 * The logical CPU to which this thread is bound when started, or -1
+		 * if this thread is not bound to any CPU.
+		 *
+		 * @see TopologyThreadFactory
+		 */
+		[Version (since="0.4.0-alpha")]
+		public int cpu {
+			get {
+				return _cpu;
+			}
+			internal set {
+				assert(!is_started);
+				_cpu = value;
+			}
+		}
+
 		/**
 		 * Whether or not this thread has been started.
 		 */
@@ -264,16 +292,21 @@ namespace Gpseq {
 		/**
 		 * Runs the given blocking task and returns the result.
 		 *
-		 * This method tries to create a new thread.
+		 * This method tries to compensate for this thread, if the number of
+		 * the threads currently compensating in the pool is less than
+		 * {@link WorkerPool.max_compensations}. A spare thread parked in the
+		 * pool is reused if any; otherwise a new thread is created.
 		 *
-		 * -> If succeed, the new thread takes the context of this thread and
-		 * runs the remaining tasks in the context. This thread runs the
-		 * blocking task and is marked as //blocked// until the task ends.
+		 * -> If succeed, the compensating thread takes the context of this
+		 * thread and runs the remaining tasks in the context. This thread runs
+		 * the blocking task and is marked as //blocked// until the task ends.
 		 * After it ends, this thread is unblocked and takes the context back,
-		 * and the new thread is terminated.
+		 * and the compensating thread becomes a spare thread of the pool, or
+		 * is terminated if the pool has enough spare threads.
 		 *
-		 * -> If failed, e.g. the maximum number of threads exceeded, this
-		 * method just runs the function without any further work.
+		 * -> If failed, e.g. the compensation cap or the maximum number of
+		 * threads exceeded, this method just runs the function without any
+		 * further work.
 		 *
 		 * This method must be called in //this// thread.
 		 *
@@ -285,17 +318,58 @@ namespace Gpseq {
 		 * @see Gpseq.blocking
 		 * @see Gpseq.blocking_get
 		 */
-		// TODO Use pooling for slave threads
 		[Version (since="0.2.0-alpha")]
 		public G blocking<G> (TaskFunc<G> func) throws Error {
+			WorkerContext? ctx;
 			lock (_context) {
-				if (_context == null) {
+				ctx = _context;
+			}
+			if (ctx == null) {
+				return func();
+			}
+
+			if ( !_pool.try_begin_compensation() ) {
+				if (_pool.stats_enabled) ctx.counters.compensation_rejected();
+				return func();
+			}
+			try {
+				if ( !compensate((!)ctx) ) {
 					return func();
 				}
+				try {
+					return func();
+				} catch (Error err) {
+					throw err;
+				} finally {
+					lock (_context) {
+						_blocked = false;
+					}
+				}
+			} finally {
+				_pool.end_compensation();
+			}
+		}
+
+		/**
+		 * Hands the context of this thread over to a spare thread or a new
+		 * slave thread, and marks this thread as blocked.
+		 *
+		 * @return true if succeeded, false otherwise
+		 */
+		private bool compensate (WorkerContext ctx) {
+			WorkerThread? spare = _pool.take_spare();
+			if (spare != null) {
+				lock (_context) {
+					_blocked = true;
+					((!)spare).adopt(this);
+				}
+				((!)spare).resume();
+				if (_pool.stats_enabled) ctx.counters.spare_reused();
+				return true;
 			}
 
 			if ( !_pool.try_new_slave() ) {
-				return func();
+				return false;
 			}
 
 			WorkerThread? slave;
@@ -307,25 +381,78 @@ namespace Gpseq {
 			_pool.add_slave((!)slave);
 			try {
 				((!)slave).start();
+				if (_pool.stats_enabled) ctx.counters.compensated();
 			} catch (Error err) {
 				_pool.new_slave_failed((!)slave);
 				move_context((!)slave, this);
-			}
-			slave = null;
-
-			try {
-				return func();
-			} catch (Error err) {
-				throw err;
-			} finally {
 				lock (_context) {
 					_blocked = false;
 				}
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * Makes this spare thread a slave of the given parent, and takes the
+		 * context of the parent.
+		 *
+		 * Called in the parent thread, while this thread is parked.
+		 */
+		private void adopt (WorkerThread parent) {
+			_parent = parent;
+			move_context(parent, this);
+		}
+
+		/**
+		 * Wakes this spare thread up after adopt(), or on termination.
+		 */
+		internal void resume () {
+			_spare_parker.unpark();
+		}
+
+		/**
+		 * Parks this slave thread as a spare thread of the pool, until it is
+		 * adopted by a new parent.
+		 *
+		 * @return true if adopted, false if this thread should terminate
+		 */
+		private bool await_adoption () {
+			_parent = null;
+			if ( !_pool.offer_spare(this) ) return false;
+
+			int64 end = get_monotonic_time() + SPARE_KEEP_ALIVE;
+			while (true) {
+				bool unparked = _spare_parker.park_until(end);
+				if (unparked) {
+					// unparked by either adopt() or termination
+					if (_parent != null) break;
+					_pool.remove_spare(this);
+					return false;
+				}
+				if ( _pool.remove_spare(this) ) {
+					return false; // kept alive long enough
+				}
+				// taken concurrently; the taker will resume this thread soon
+				end = int64.MAX;
+			}
+
+			int cpu = _parent._cpu;
+			if (cpu >= 0 && cpu != _cpu) {
+				_cpu = cpu;
+				set_thread_affinity(cpu);
 			}
+			return true;
 		}
 
 		/**
 		 * Top-level loop for worker threads
+		 *
+		 * An idle thread first spins -- rescans without yielding -- up to an
+		 * adaptive number of times, then yields up to
+		 * MAX_THREAD_IDLE_ITERATIONS times, and then parks. The spin budget
+		 * grows when tasks are found while spinning or yielding, and shrinks
+		 * when the thread parks.
 		 */
 		internal void work () {
 			int barrens = 0;
@@ -338,21 +465,27 @@ namespace Gpseq {
 					return;
 				}
 
-				Task? pop = ctx.work_queue.poll_tail();
+				Task? pop = _pool.poll_urgent() ?? ctx.work_queue.poll_tail();
 				if (pop != null) {
 					if (_seeking) {
 						_seeking = false;
 						_pool.signal_new_task(false);
 					}
-					pop.compute();
+					if (barrens > 0) {
+						_spins = int.min(_spins * 2, SPINS_MAX);
+					}
+					execute(ctx, pop);
 					barrens = 0;
 				} else {
 					QueueBalancer bal = ctx.balancer;
-					bal.no_tasks(ctx);
 					barrens++;
-					if (barrens > MAX_THREAD_IDLE_ITERATIONS) {
+					if (barrens > _spins) {
+						bal.no_tasks(ctx);
+					}
+					if (barrens > _spins + MAX_THREAD_IDLE_ITERATIONS) {
 						if (_parent == null) {
-							_pool.block_idle(this);
+							_spins = int.max(_spins / 2, SPINS_MIN);
+							_pool.park_idle(ctx);
 							_seeking = true;
 							if (_pool.is_terminating_started) return;
 						}
@@ -371,7 +504,7 @@ namespace Gpseq {
 			int ctr = interval;
 			while (true) {
 				if (check_interval(ref ctr, ref interval)) {
-					if (task.future.ready) {
+					if (task.is_done) {
 						break;
 					}
 				}
@@ -383,9 +516,18 @@ namespace Gpseq {
 					continue;
 				}
 
-				Task? pop = ctx.work_queue.poll_tail();
+				Task? pop = _pool.poll_urgent() ?? ctx.work_queue.poll_tail();
 				if (pop != null) {
-					pop.invoke();
+					if (_pool.stats_enabled) {
+						int64 start = get_monotonic_time();
+						try {
+							pop.invoke();
+						} finally {
+							ctx.counters.task_executed(get_monotonic_time() - start);
+						}
+					} else {
+						pop.invoke();
+					}
 					if (pop == task) break;
 				} else {
 					QueueBalancer bal = ctx.balancer;
@@ -395,6 +537,16 @@ namespace Gpseq {
 			}
 		}
 
+		private void execute (WorkerContext ctx, Task task) {
+			if (_pool.stats_enabled) {
+				int64 start = get_monotonic_time();
+				task.compute();
+				ctx.counters.task_executed(get_monotonic_time() - start);
+			} else {
+				task.compute();
+			}
+		}
+
 		private bool check_interval (ref int count, ref int interval) {
 			++count;
 			if (count > interval) {
@@ -412,7 +564,10 @@ namespace Gpseq {
 		 * Thread loop function.
 		 */
 		private void* run () {
-			work();
+			if (_cpu >= 0) set_thread_affinity(_cpu);
+			do {
+				work();
+			} while (_parent != null && !_pool.is_terminating_started && await_adoption());
 			lock (_thread) {
 				_terminated = true;
 			}
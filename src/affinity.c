@@ -0,0 +1,61 @@
+/* affinity.c
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#	define _GNU_SOURCE
+#endif
+
+#include <glib.h>
+
+#if defined(__linux__)
+#	include <sched.h>
+#endif
+
+/**
+ * gpseq_set_thread_affinity:
+ * @cpu: a zero-based index of a logical CPU
+ *
+ * Binds the calling thread to the given logical CPU.
+ *
+ * This function is supported only on Linux. On other platforms, this function
+ * does nothing and returns %FALSE.
+ *
+ * Returns: %TRUE if the thread has been bound, and %FALSE otherwise
+ **/
+gboolean gpseq_set_thread_affinity (gint cpu);
+
+#if defined(__linux__) && defined(CPU_SET)
+
+gboolean gpseq_set_thread_affinity (gint cpu) {
+	cpu_set_t set;
+	if (cpu < 0 || cpu >= CPU_SETSIZE) return FALSE;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+#else /* defined(__linux__) && defined(CPU_SET) */
+
+gboolean gpseq_set_thread_affinity (gint cpu) {
+	(void) cpu;
+	return FALSE;
+}
+
+#endif /* defined(__linux__) && defined(CPU_SET) */
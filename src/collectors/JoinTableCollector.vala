@@ -0,0 +1,133 @@
+/* JoinTableCollector.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+/**
+ * A collector that builds a {@link JoinTable} of the elements, keyed by the
+ * given function.
+ *
+ * Each leaf hash-partitions its entries, and the i-th partitions of all the
+ * leaves are built into the i-th partition of the table by one task, so the
+ * table is built in parallel without locks.
+ *
+ * The collector builds one table, and must be used for one reduction.
+ */
+private class Gpseq.Collectors.JoinTableCollector<K,V> : Object, Collector<JoinTable<K,V>,Object,V> {
+	private MapFunc<K,V> _key;
+	private JoinTable<K,V> _table;
+	private Executor _executor;
+
+	/**
+	 * Creates a new join table collector.
+	 *
+	 * @param key a function that maps the elements to their keys
+	 * @param partitions the number of partitions. must be a power of two
+	 * @param executor an executor that builds the partitions
+	 */
+	public JoinTableCollector (owned MapFunc<K,V> key, int partitions, Executor executor) {
+		_key = (owned) key;
+		_table = new JoinTable<K,V>(partitions);
+		_executor = executor;
+	}
+
+	public CollectorFeatures features {
+		get {
+			return 0;
+		}
+	}
+
+	public Object create_accumulator () throws Error {
+		return new JoinRuns<K,V>(_table.num_partitions);
+	}
+
+	public void accumulate (V v, Object a) throws Error {
+		K key = _key(v);
+		uint h = _table.hash_of(key);
+		((JoinRuns<K,V>) a).first.add(_table.partition_of(h), h, (owned) key, v);
+	}
+
+	public Object combine (Object a, Object b) throws Error {
+		// defer the build until finish, where partitions are built in parallel
+		((JoinRuns<K,V>) a).runs.add_all( ((JoinRuns<K,V>) b).runs );
+		return a;
+	}
+
+	public JoinTable<K,V> finish (Object a) throws Error {
+		Gee.List<JoinRun<K,V>> runs = ((JoinRuns<K,V>) a).runs;
+		int partitions = _table.num_partitions;
+		if (runs.size == 1 || partitions == 1) {
+			for (int i = 0; i < partitions; i++) {
+				_table.build_partition(i, runs);
+			}
+		} else {
+			var task = new JoinTableBuildTask<K,V>(_table, runs, 0, partitions, null, _executor);
+			task.fork();
+			task.join();
+		}
+		return _table;
+	}
+}
+
+/**
+ * The entry runs of consecutive leaves, in encounter order.
+ */
+private class Gpseq.Collectors.JoinRuns<K,V> : Object {
+	public Gee.List<JoinRun<K,V>> runs = new ArrayList<JoinRun<K,V>>();
+	public JoinRun<K,V> first; // the run that accumulates elements
+
+	public JoinRuns (int partitions) {
+		first = new JoinRun<K,V>(partitions);
+		runs.add(first);
+	}
+}
+
+/**
+ * A task which builds a range of partitions, one partition per leaf.
+ */
+private class Gpseq.Collectors.JoinTableBuildTask<K,V> : RangeTask<void*> {
+	private JoinTable<K,V> _table;
+	private Gee.List<JoinRun<K,V>> _runs;
+
+	public JoinTableBuildTask (JoinTable<K,V> table, Gee.List<JoinRun<K,V>> runs,
+			int start, int end, JoinTableBuildTask<K,V>? parent, Executor executor)
+	{
+		base(start, end, parent, 1, -1, executor);
+		_table = table;
+		_runs = runs;
+	}
+
+	protected override void* leaf_compute (int start, int end) throws Error {
+		for (int i = start; i < end; i++) {
+			_table.build_partition(i, _runs);
+		}
+		return null;
+	}
+
+	protected override void* merge_results (owned void* left, owned void* right) {
+		return null;
+	}
+
+	protected override RangeTask<void*> make_child (int start, int end) {
+		var task = new JoinTableBuildTask<K,V>(_table, _runs, start, end, this, executor);
+		task.depth = depth + 1;
+		return task;
+	}
+}
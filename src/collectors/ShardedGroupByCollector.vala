@@ -0,0 +1,196 @@
+/* ShardedGroupByCollector.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+private class Gpseq.Collectors.ShardedGroupByCollector<K,V,G> : Object, Collector<Map<K,V>,Object,G> {
+	private const int64 KEYS_PER_SHARD = 4096;
+
+	private MapFunc<K,G> _classifier;
+	private Collector<V,Object,G> _downstream;
+	private HashDataFunc<K> _hash;
+	private int _shards;
+	private Executor _executor;
+
+	/**
+	 * Creates a new sharded group by collector.
+	 *
+	 * @param classifier a classifier function mapping elements to keys
+	 * @param downstream a downstream collector
+	 * @param cardinality an estimate of the number of distinct keys, or a
+	 * negative value if unknown
+	 * @param executor an executor that merges the shards
+	 */
+	public ShardedGroupByCollector (owned MapFunc<K,G> classifier, Collector<V,Object,G> downstream,
+			int64 cardinality, Executor executor) {
+		_classifier = (owned) classifier;
+		_downstream = downstream;
+		_hash = Functions.get_hash_func_for(typeof(K));
+		_shards = resolve_shards(cardinality, executor.parallels);
+		_executor = executor;
+	}
+
+	/**
+	 * Gets the number of shards: a power of two, large enough to balance the
+	 * shard merges, but not so large that shards of low cardinality groups
+	 * are mostly empty.
+	 */
+	private static int resolve_shards (int64 cardinality, int parallels) {
+		int64 max = (int64) parallels * 4;
+		if (cardinality >= 0) {
+			max = int64.min(max, cardinality / KEYS_PER_SHARD);
+		}
+		int shards = 1;
+		while (shards * 2 <= max) shards *= 2;
+		return shards;
+	}
+
+	public CollectorFeatures features {
+		get {
+			return 0;
+		}
+	}
+
+	public Object create_accumulator () throws Error {
+		return new ShardedGroups<K>(_shards);
+	}
+
+	public void accumulate (G g, Object a) throws Error {
+		K key = _classifier(g);
+		HashMap<K,Object> shard = ((ShardedGroups<K>) a).first.shards[shard_of(key)];
+		Object? container = shard[key];
+		if (container == null) {
+			container = _downstream.create_accumulator();
+			shard[key] = container;
+		}
+		_downstream.accumulate(g, container);
+	}
+
+	public Object combine (Object a, Object b) throws Error {
+		// defer the merge until finish, where shards are merged in parallel
+		((ShardedGroups<K>) a).runs.add_all( ((ShardedGroups<K>) b).runs );
+		return a;
+	}
+
+	public Map<K,V> finish (Object a) throws Error {
+		Gee.List<ShardRun<K>> runs = ((ShardedGroups<K>) a).runs;
+		if (runs.size == 1 || _shards == 1) {
+			for (int i = 0; i < _shards; i++) {
+				merge_shard(runs, i);
+			}
+		} else {
+			var task = new ShardMergeTask<K,V,G>(this, runs, 0, _shards, null, _executor);
+			task.fork();
+			task.join();
+		}
+
+		var result = new HashMap<K,V>();
+		ShardRun<K> first = runs[0];
+		for (int i = 0; i < _shards; i++) {
+			result.set_all( (Map<K,V>) first.shards[i] );
+		}
+		return result;
+	}
+
+	/**
+	 * Merges the i-th shards of all the runs into that of the first run, in
+	 * encounter order, and finishes the downstream accumulators of it.
+	 */
+	internal void merge_shard (Gee.List<ShardRun<K>> runs, int i) throws Error {
+		HashMap<K,Object> target = runs[0].shards[i];
+		for (int r = 1; r < runs.size; r++) {
+			foreach (Map.Entry<K,Object> e in runs[r].shards[i].entries) {
+				Object? container = target[e.key];
+				target[e.key] = container == null
+						? e.value
+						: _downstream.combine(container, e.value);
+			}
+			runs[r].shards[i] = null;
+		}
+		foreach (Map.Entry<K,Object> e in target.entries) {
+			e.value = (Object) _downstream.finish(e.value);
+		}
+	}
+
+	private inline int shard_of (K key) {
+		uint h = _hash(key);
+		return (int) ((h ^ (h >> 16)) & (_shards - 1));
+	}
+}
+
+/**
+ * The per-leaf groups, each of which is hash-partitioned into shards.
+ */
+private class Gpseq.Collectors.ShardRun<K> : Object {
+	public HashMap<K,Object>?[] shards;
+
+	public ShardRun (int n) {
+		shards = new HashMap<K,Object>?[n];
+		for (int i = 0; i < n; i++) {
+			shards[i] = new HashMap<K,Object>();
+		}
+	}
+}
+
+/**
+ * The runs of consecutive leaves, in encounter order.
+ */
+private class Gpseq.Collectors.ShardedGroups<K> : Object {
+	public Gee.List<ShardRun<K>> runs = new ArrayList<ShardRun<K>>();
+	public ShardRun<K> first; // the run that accumulates elements
+
+	public ShardedGroups (int shards) {
+		first = new ShardRun<K>(shards);
+		runs.add(first);
+	}
+}
+
+/**
+ * A task which merges a range of shards, one shard per leaf.
+ */
+private class Gpseq.Collectors.ShardMergeTask<K,V,G> : RangeTask<void*> {
+	private ShardedGroupByCollector<K,V,G> _collector;
+	private Gee.List<ShardRun<K>> _runs;
+
+	public ShardMergeTask (ShardedGroupByCollector<K,V,G> collector, Gee.List<ShardRun<K>> runs,
+			int start, int end, ShardMergeTask<K,V,G>? parent, Executor executor)
+	{
+		base(start, end, parent, 1, -1, executor);
+		_collector = collector;
+		_runs = runs;
+	}
+
+	protected override void* leaf_compute (int start, int end) throws Error {
+		for (int i = start; i < end; i++) {
+			_collector.merge_shard(_runs, i);
+		}
+		return null;
+	}
+
+	protected override void* merge_results (owned void* left, owned void* right) {
+		return null;
+	}
+
+	protected override RangeTask<void*> make_child (int start, int end) {
+		var task = new ShardMergeTask<K,V,G>(_collector, _runs, start, end, this, executor);
+		task.depth = depth + 1;
+		return task;
+	}
+}
@@ -0,0 +1,56 @@
+/* TopKCollector.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gee;
+
+private class Gpseq.Collectors.TopKCollector<G> : Object, Collector<Gee.List<G>,TopKBuffer<G>,G> {
+	private CompareDataFunc<G> _compare;
+	private int _k;
+
+	public TopKCollector (int64 k, owned CompareDataFunc<G> compare) {
+		_compare = (owned) compare;
+		_k = (int) int64.min(k, MAX_ARRAY_LENGTH);
+	}
+
+	public CollectorFeatures features {
+		get {
+			return 0;
+		}
+	}
+
+	public TopKBuffer<G> create_accumulator () throws Error {
+		return new TopKBuffer<G>(_k, _compare);
+	}
+
+	public void accumulate (G g, TopKBuffer<G> a) throws Error {
+		a.offer(g);
+	}
+
+	public TopKBuffer<G> combine (TopKBuffer<G> a, TopKBuffer<G> b) throws Error {
+		a.merge(b);
+		return a;
+	}
+
+	public Gee.List<G> finish (TopKBuffer<G> a) throws Error {
+		var list = new ArrayList<G>();
+		list.add_all_array(a.take_sorted());
+		return list;
+	}
+}
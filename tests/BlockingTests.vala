@@ -27,6 +27,7 @@ public class BlockingTests : Gpseq.TestSuite {
 	public BlockingTests () {
 		base("blocking");
 		add_test("blocking-tasks", test_blocking_tasks);
+		add_test("blocking-tasks:bounded", test_bounded_blocking_tasks);
 	}
 
 	public override void set_up () {
@@ -52,4 +53,54 @@ public class BlockingTests : Gpseq.TestSuite {
 			assert_not_reached();
 		}
 	}
+
+	private void test_bounded_blocking_tasks () {
+		const int MAX_COMPENSATIONS = 4;
+		const int TASKS = 20;
+		try {
+			var pool = new WorkerPool(2, WorkerPool.get_default_factory());
+			pool.max_compensations = MAX_COMPENSATIONS;
+			pool.stats_enabled = true;
+			int max_seen = 0;
+
+			for (int round = 0; round < 2; round++) {
+				var tasks = new GenericArray<FuncTask<void*>>();
+				for (int i = 0; i < TASKS; i++) {
+					var t = new FuncTask<void*>(() => {
+						blocking(() => {
+							int n = pool.num_compensations;
+							int old;
+							do {
+								old = AtomicInt.get(ref max_seen);
+							} while (n > old && !AtomicInt.compare_and_exchange(ref max_seen, old, n));
+							Thread.usleep(SECONDS / 20);
+						});
+						return null;
+					});
+					pool.submit(t);
+					tasks.add(t);
+				}
+				for (int i = 0; i < tasks.length; i++) {
+					tasks[i].future.wait();
+				}
+				// the compensating threads become spare threads
+				int64 end = get_monotonic_time() + 5*SECONDS;
+				while (pool.num_spare_threads == 0 && get_monotonic_time() < end) {
+					Thread.usleep(1000);
+				}
+				assert(pool.num_spare_threads > 0);
+				assert(pool.num_spare_threads <= pool.max_spare_threads);
+			}
+
+			assert(AtomicInt.get(ref max_seen) <= MAX_COMPENSATIONS);
+			// the excess of spare threads may be terminating
+			assert(pool.num_threads <= pool.parallels + MAX_COMPENSATIONS + pool.max_spare_threads);
+			WorkerStats stats = pool.get_stats();
+			assert(stats.compensations > 0);
+			assert(stats.spare_reuses > 0);
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
 }
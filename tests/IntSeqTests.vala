@@ -23,6 +23,8 @@ using Gee;
 using TestUtils;
 
 public class IntSeqTests : SeqTests<int> {
+	private const int SCAN_LENGTH = 65536;
+
 	private Rand _rand;
 
 	public IntSeqTests () {
@@ -33,6 +35,28 @@ public class IntSeqTests : SeqTests<int> {
 
 	private void register_tests () {
 		add_test("iterate", test_iterate);
+		add_test("range", () => test_range(false));
+		add_test("range:parallel", () => test_range(true));
+		add_test("to_generic_array:exact", () => test_to_generic_array_exact(false));
+		add_test("to_generic_array:exact:parallel", () => test_to_generic_array_exact(true));
+		add_test("scan", () => test_scan(false));
+		add_test("scan:parallel", () => test_scan(true));
+		add_test("sliding_reduce", () => test_sliding_reduce(false));
+		add_test("sliding_reduce:parallel", () => test_sliding_reduce(true));
+		add_test("flat_map_spliterator", () => test_flat_map_spliterator(false));
+		add_test("flat_map_spliterator:parallel", () => test_flat_map_spliterator(true));
+		add_test("flat_map_spliterator:split-inner", test_flat_map_spliterator_split_inner);
+		add_test("flat_map_spliterator:oversized-inner", test_flat_map_spliterator_oversized_inner);
+		add_test("flat_map_seq", () => test_flat_map_seq(false));
+		add_test("flat_map_seq:parallel", () => test_flat_map_seq(true));
+		add_test("join", () => test_join(false));
+		add_test("join:parallel", () => test_join(true));
+		add_test("left_join", () => test_left_join(false));
+		add_test("left_join:parallel", () => test_left_join(true));
+		add_test("semi_join", () => test_semi_join(false));
+		add_test("semi_join:parallel", () => test_semi_join(true));
+		add_test("co_group", () => test_co_group(false));
+		add_test("co_group:parallel", () => test_co_group(true));
 	}
 
 	protected override Seq<int> create_rand_seq () {
@@ -118,4 +142,366 @@ public class IntSeqTests : SeqTests<int> {
 		Seq.iterate<int>(0, i => false, i => i).foreach(i => n++).value;
 		assert(n == 0);
 	}
+
+	private void test_range (bool parallel) {
+		int[,] cases = {
+			{0, 100000, 1},
+			{5, 100, 7},
+			{100, -3, -3},
+			{-10, 10, 20},
+			{0, 0, 1},
+			{10, 0, 1},
+			{0, 10, -1}
+		};
+		for (int c = 0; c < cases.length[0]; c++) {
+			int start = cases[c,0];
+			int end = cases[c,1];
+			int step = cases[c,2];
+			Seq<int> seq = Seq.range(start, end, step, TestTaskEnv.get_instance());
+			if (parallel) seq = seq.parallel();
+			GenericArray<int> result = seq.to_generic_array().value;
+
+			int i = 0;
+			for (int x = start; step > 0 ? x < end : x > end; x += step) {
+				assert(result[i++] == x);
+			}
+			assert(result.length == i);
+		}
+
+		Seq<int> whole = Seq.range(0, 100000, 1, TestTaskEnv.get_instance());
+		if (parallel) whole = whole.parallel();
+		assert(whole.count().value == 100000);
+		whole = Seq.range(0, 100000, 1, TestTaskEnv.get_instance());
+		if (parallel) whole = whole.parallel();
+		int64 sum = whole.fold<int64?>((g, a) => a + g, (a, b) => a + b, 0).value;
+		assert(sum == (int64) 100000 * 99999 / 2);
+	}
+
+	private void test_to_generic_array_exact (bool parallel) {
+		int[] array = create_scan_array();
+		Seq<int> seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<int> result = seq.map<int>(g => g * 3).map<int>(g => g + 1).to_generic_array().value;
+		assert(result.length == array.length);
+		for (int i = 0; i < array.length; i++) {
+			assert(result[i] == array[i] * 3 + 1);
+		}
+
+		// not exactly sized; collected as usual
+		seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		result = seq.filter(g => g > 0).to_generic_array().value;
+		int j = 0;
+		for (int i = 0; i < array.length; i++) {
+			if (array[i] > 0) assert(result[j++] == array[i]);
+		}
+		assert(result.length == j);
+
+		seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		var future = seq.map<int>(g => {
+			if (g == 3) throw new OptionalError.NOT_PRESENT("g == 3");
+			return g;
+		}).to_generic_array();
+		try {
+			future.wait();
+			assert_not_reached();
+		} catch (Error err) {
+			assert(err is OptionalError.NOT_PRESENT);
+		}
+
+		// more elements than the exact size; nothing is stored out of the array
+		seq = new Seq<int>(new MisreportedSpliterator(array), TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		try {
+			seq.to_generic_array().wait();
+			assert_not_reached();
+		} catch (Error err) {
+			assert(err is SpliteratorError.SIZE_MISMATCH);
+		}
+	}
+
+	private int[] create_scan_array () {
+		int[] array = new int[SCAN_LENGTH];
+		for (int i = 0; i < array.length; i++) {
+			array[i] = i % 7 - 3;
+		}
+		return array;
+	}
+
+	private void test_scan (bool parallel) {
+		int[] array = create_scan_array();
+		Seq<int> seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<int> result = seq.scan((a, b) => a + b, 10).to_generic_array().value;
+		assert(result.length == array.length);
+		int total = 10;
+		for (int i = 0; i < array.length; i++) {
+			total += array[i];
+			assert(result[i] == total);
+		}
+
+		// not commutative; the encounter order must be kept
+		seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		result = seq.scan((a, b) => b, -1).to_generic_array().value;
+		for (int i = 0; i < array.length; i++) {
+			assert(result[i] == array[i]);
+		}
+
+		int[] empty = {};
+		assert(Seq.of_array<int>(empty).scan((a, b) => a + b, 0).count().value == 0);
+	}
+
+	private void test_sliding_reduce (bool parallel) {
+		int[] array = create_scan_array();
+		int[] windows = {1, 2, 5, 64, 1000};
+		foreach (int w in windows) {
+			Seq<int> seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+			if (parallel) seq = seq.parallel();
+			GenericArray<int> result = seq.sliding_reduce(w, (a, b) => a + b).to_generic_array().value;
+			assert(result.length == array.length - w + 1);
+			int sum = 0;
+			for (int i = 0; i < array.length; i++) {
+				sum += array[i];
+				if (i >= w) sum -= array[i - w];
+				if (i >= w - 1) assert(result[i - w + 1] == sum);
+			}
+
+			// not commutative; each window must keep its encounter order
+			seq = Seq.of_array<int>(array, TestTaskEnv.get_instance());
+			if (parallel) seq = seq.parallel();
+			result = seq.sliding_reduce(w, (a, b) => a).to_generic_array().value;
+			for (int i = 0; i < result.length; i++) {
+				assert(result[i] == array[i]);
+			}
+		}
+
+		int[] small = {1, 2};
+		assert(Seq.of_array<int>(small).sliding_reduce(3, (a, b) => a + b).count().value == 0);
+	}
+
+	/**
+	 * Expands n to 0, 1, ..., the first element to many elements and the
+	 * others to a few elements.
+	 */
+	private Spliterator<int> expand (int n) {
+		int len = n == 0 ? SCAN_LENGTH : n % 5;
+		int[] array = new int[len];
+		for (int i = 0; i < len; i++) array[i] = i;
+		return new ArraySpliterator<int>((owned) array, 0, len);
+	}
+
+	private void test_flat_map_spliterator (bool parallel) {
+		const int OUTER = 100;
+		int[] outer = new int[OUTER];
+		for (int i = 0; i < OUTER; i++) outer[i] = i;
+		Seq<int> seq = Seq.of_array<int>(outer, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<int> result = seq.flat_map_spliterator<int>(n => expand(n))
+			.to_generic_array().value;
+
+		int idx = 0;
+		for (int n = 0; n < OUTER; n++) {
+			int len = n == 0 ? SCAN_LENGTH : n % 5;
+			for (int i = 0; i < len; i++) {
+				assert(result[idx++] == i);
+			}
+		}
+		assert(idx == result.length);
+	}
+
+	private void test_flat_map_spliterator_split_inner () {
+		int[] outer = {0};
+		Spliterator<int> spliter = Seq.of_array<int>(outer, TestTaskEnv.get_instance())
+			.parallel()
+			.flat_map_spliterator<int>(n => expand(n))
+			.spliterator();
+		assert(!spliter.is_size_known);
+
+		// the only outer element is mapped and its elements are split
+		Spliterator<int>? split = spliter.try_split();
+		assert(split != null);
+		assert(split.is_size_known && spliter.is_size_known);
+		assert(split.estimated_size + spliter.estimated_size == SCAN_LENGTH);
+
+		int64 count = 0;
+		int prev = -1;
+		try {
+			EachChunkFunc<int> check = chunk => {
+				for (int i = 0; i < chunk.length; i++) {
+					assert(chunk[i] == prev + 1);
+					prev = chunk[i];
+					count++;
+				}
+				return true;
+			};
+			split.each_chunk(check);
+			spliter.each_chunk(check);
+		} catch (Error err) {
+			error(err.message);
+		}
+		assert(count == SCAN_LENGTH);
+	}
+
+	private void test_flat_map_spliterator_oversized_inner () {
+		const int INNER = 1 << 21;
+		int[] outer = {1, 0};
+
+		int forks = 0;
+		set_task_trace_func((event, task) => {
+			if (event == TaskTraceEvent.FORK) AtomicInt.inc(ref forks);
+		});
+		// the default task env resolves a threshold larger than INNER, since
+		// the size of the seq is unknown
+		int64 count = Seq.of_array<int>(outer).parallel()
+			.flat_map_spliterator<int>(n => {
+				int len = n == 0 ? INNER : 1;
+				return new ArraySpliterator<int>(new int[len], 0, len);
+			})
+			.count().value;
+		set_task_trace_func(null);
+		assert(count == INNER + 1);
+
+		// the outer elements are split first, and then the inner spliterator
+		// is split down to the threshold for its own size
+		TaskEnv env = TaskEnv.get_common_task_env();
+		int64 threshold = env.resolve_threshold(INNER, env.executor.parallels);
+		if (threshold < INNER) {
+			assert(AtomicInt.get(ref forks) >= 1 + (INNER / threshold - 1));
+		}
+	}
+
+	private void test_flat_map_seq (bool parallel) {
+		int[] outer = {1, 2, 3, 4};
+		Seq<int> seq = Seq.of_array<int>(outer, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		int sum = seq.flat_map_seq<int>(n => {
+			int[] array = new int[n * 1000];
+			for (int i = 0; i < array.length; i++) array[i] = i;
+			return Seq.of_owned_array<int>((owned) array).parallel();
+		}).fold<int>((g, a) => g + a, (a, b) => a + b, 0).value;
+		int expected = 0;
+		foreach (int n in outer) expected += n * 1000 * (n * 1000 - 1) / 2;
+		assert(sum == expected);
+	}
+
+	private Seq<string> create_join_other () {
+		// keys 0..999, three elements per key
+		return Seq.range(0, 3000, 1, TestTaskEnv.get_instance()).map<string>(i => i.to_string());
+	}
+
+	private void test_join (bool parallel) {
+		Seq<int> seq = Seq.range(0, 20000, 1, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<string> result = seq.join<string,int,string>(
+				create_join_other(), g => g, s => int.parse(s) % 1000, (g, s) => s)
+				.to_generic_array().value;
+		assert(result.length == 3000);
+		for (int g = 0; g < 1000; g++) {
+			for (int j = 0; j < 3; j++) {
+				assert(result[g * 3 + j] == (g + 1000 * j).to_string());
+			}
+		}
+	}
+
+	private void test_left_join (bool parallel) {
+		Seq<int> seq = Seq.range(0, 1500, 1, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<string> result = seq.left_join<string,int,string>(
+				create_join_other(), g => g, s => int.parse(s) % 1000, (g, s) => s ?? "-")
+				.to_generic_array().value;
+		assert(result.length == 3500);
+		for (int g = 0; g < 1000; g++) {
+			for (int j = 0; j < 3; j++) {
+				assert(result[g * 3 + j] == (g + 1000 * j).to_string());
+			}
+		}
+		for (int i = 3000; i < 3500; i++) {
+			assert(result[i] == "-");
+		}
+	}
+
+	private void test_semi_join (bool parallel) {
+		Seq<int> seq = Seq.range(0, 20000, 1, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<int> semi = seq.semi_join<string,int>(
+				create_join_other(), g => g, s => int.parse(s) % 1000)
+				.to_generic_array().value;
+		assert(semi.length == 1000);
+		for (int i = 0; i < 1000; i++) {
+			assert(semi[i] == i);
+		}
+
+		seq = Seq.range(0, 20000, 1, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<int> anti = seq.anti_join<string,int>(
+				create_join_other(), g => g, s => int.parse(s) % 1000)
+				.to_generic_array().value;
+		assert(anti.length == 19000);
+		for (int i = 0; i < 19000; i++) {
+			assert(anti[i] == i + 1000);
+		}
+	}
+
+	private void test_co_group (bool parallel) {
+		// keys 0..499, four elements per key
+		Seq<int> seq = Seq.range(0, 2000, 1, TestTaskEnv.get_instance());
+		if (parallel) seq = seq.parallel();
+		GenericArray<string> result = seq.co_group<string,int,string>(
+				create_join_other(), g => g % 500, s => int.parse(s) % 1000, (key, left, right) => {
+					return "%d %d %d %s".printf(key, left.size, right.size,
+							left.size > 0 ? left[left.size - 1].to_string() : right[0]);
+				}).to_generic_array().value;
+		assert(result.length == 1000);
+		var groups = new HashSet<string>();
+		foreach (unowned string group in result.data) {
+			groups.add(group);
+		}
+		for (int key = 0; key < 1000; key++) {
+			string expected = key < 500
+					? "%d 4 3 %d".printf(key, key + 1500)
+					: "%d 0 3 %d".printf(key, key);
+			assert(expected in groups);
+		}
+	}
+}
+
+/**
+ * An exactly sized spliterator which reports one element less than it has.
+ */
+private class MisreportedSpliterator : Object, Spliterator<int> {
+	private Spliterator<int> _spliterator;
+
+	public MisreportedSpliterator (int[] array) {
+		_spliterator = new ArraySpliterator<int>(array, 0, array.length);
+	}
+
+	public Spliterator<int>? try_split () {
+		return null;
+	}
+
+	public bool try_advance (Func<int> consumer) throws Error {
+		return _spliterator.try_advance(consumer);
+	}
+
+	public int64 estimated_size {
+		get {
+			return _spliterator.estimated_size - 1;
+		}
+	}
+
+	public bool is_size_known {
+		get {
+			return true;
+		}
+	}
+
+	public SpliteratorCharacteristics characteristics {
+		get {
+			return SpliteratorCharacteristics.ORDERED
+				| SpliteratorCharacteristics.SIZED
+				| SpliteratorCharacteristics.SUBSIZED;
+		}
+	}
 }
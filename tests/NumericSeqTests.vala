@@ -0,0 +1,151 @@
+/* NumericSeqTests.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gpseq;
+
+public class NumericSeqTests : Gpseq.TestSuite {
+	private const int LENGTH = 100000;
+
+	public NumericSeqTests () {
+		base("numeric-seq");
+		add_test("int64:sum;average", () => test_int64_sum(false));
+		add_test("int64:sum;average:parallel", () => test_int64_sum(true));
+		add_test("int64:min;max", () => test_int64_min_max(false));
+		add_test("int64:min;max:parallel", () => test_int64_min_max(true));
+		add_test("int64:histogram", () => test_int64_histogram(false));
+		add_test("int64:histogram:parallel", () => test_int64_histogram(true));
+		add_test("int64:empty", test_int64_empty);
+		add_test("double:sum;average", () => test_double_sum(false));
+		add_test("double:sum;average:parallel", () => test_double_sum(true));
+		add_test("double:min;max", () => test_double_min_max(false));
+		add_test("double:min;max:parallel", () => test_double_min_max(true));
+		add_test("double:histogram", () => test_double_histogram(false));
+		add_test("double:histogram:parallel", () => test_double_histogram(true));
+	}
+
+	private Int64Seq int64_seq (bool parallel) {
+		int64[] array = new int64[LENGTH];
+		for (int i = 0; i < LENGTH; i++) {
+			array[i] = i + 1;
+		}
+		Int64Seq seq = Int64Seq.of_owned_array((owned) array);
+		return parallel ? seq.parallel() : seq;
+	}
+
+	private DoubleSeq double_seq (bool parallel) {
+		double[] array = new double[LENGTH];
+		for (int i = 0; i < LENGTH; i++) {
+			array[i] = (i + 1) * 0.5;
+		}
+		DoubleSeq seq = DoubleSeq.of_owned_array((owned) array);
+		return parallel ? seq.parallel() : seq;
+	}
+
+	private void test_int64_sum (bool parallel) {
+		try {
+			Int64Seq seq = int64_seq(parallel);
+			int64 expected = (int64) LENGTH * (LENGTH + 1) / 2;
+			assert(seq.sum().wait() == expected);
+			assert(seq.average().wait() == (LENGTH + 1) / 2.0);
+			assert(seq.count().wait() == LENGTH);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_int64_min_max (bool parallel) {
+		try {
+			int[] array = new int[LENGTH];
+			for (int i = 0; i < LENGTH; i++) {
+				array[i] = (i * 7919) % LENGTH - LENGTH / 2;
+			}
+			Int64Seq seq = Int64Seq.of_int_array(array);
+			if (parallel) seq = seq.parallel();
+			assert(seq.min().wait().value == -LENGTH / 2);
+			assert(seq.max().wait().value == LENGTH - 1 - LENGTH / 2);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_int64_histogram (bool parallel) {
+		try {
+			Histogram hist = int64_seq(parallel).histogram(1, LENGTH / 2 + 1, 10).wait();
+			assert(hist.bins == 10);
+			assert(hist.underflow == 0);
+			assert(hist.overflow == LENGTH / 2);
+			for (int i = 0; i < hist.bins; i++) {
+				assert(hist[i] == LENGTH / 20);
+			}
+			assert(hist.total == LENGTH);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_int64_empty () {
+		try {
+			int64[] array = {};
+			Int64Seq seq = Int64Seq.of_array(array);
+			assert(seq.sum().wait() == 0);
+			assert(seq.average().wait() == 0);
+			assert(!seq.min().wait().is_present);
+			assert(!seq.parallel().max().wait().is_present);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_double_sum (bool parallel) {
+		try {
+			DoubleSeq seq = double_seq(parallel);
+			double expected = (double) LENGTH * (LENGTH + 1) / 4;
+			assert(seq.sum().wait() == expected);
+			assert(seq.average().wait() == expected / LENGTH);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_double_min_max (bool parallel) {
+		try {
+			DoubleSeq seq = double_seq(parallel);
+			assert(seq.min().wait().value == 0.5);
+			assert(seq.max().wait().value == LENGTH * 0.5);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_double_histogram (bool parallel) {
+		try {
+			double[] array = {-1.0, 0.0, 0.25, 0.5, 0.75, 0.99, 1.0, double.NAN};
+			DoubleSeq seq = DoubleSeq.of_array(array);
+			if (parallel) seq = seq.parallel();
+			Histogram hist = seq.histogram(0, 1, 4).wait();
+			assert(hist.underflow == 1);
+			assert(hist.overflow == 1);
+			assert(hist[0] == 1 && hist[1] == 1 && hist[2] == 1 && hist[3] == 2);
+			assert(hist.total == 7);
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+}
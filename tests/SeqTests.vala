@@ -57,6 +57,10 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 
 		add_test("distinct", () => test_distinct(false), prepare);
 		add_test("distinct:parallel", () => test_distinct(true), prepare);
+		add_test("distinct:sorted", () => test_sorted_distinct(false), prepare);
+		add_test("distinct:sorted:parallel", () => test_sorted_distinct(true), prepare);
+		add_test("distinct:ordered", () => test_ordered_distinct(false), prepare);
+		add_test("distinct:ordered:parallel", () => test_ordered_distinct(true), prepare);
 
 		add_test("all_match", () => test_all_match(false), prepare);
 		add_test("all_match:parallel", () => test_all_match(true), prepare);
@@ -149,6 +153,8 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		add_test("chop_ordered:short-circuit-infinite:parallel", () => test_chop_ordered_short_circuiting(true), prepare);
 
 		add_test("filter", test_filter, prepare);
+		add_test("filter:array-chunks", () => test_filter_array_chunks(false), prepare);
+		add_test("filter:array-chunks:parallel", () => test_filter_array_chunks(true), prepare);
 
 		add_test("fold", () => test_fold(false), prepare);
 		add_test("fold:parallel", () => test_fold(true), prepare);
@@ -167,9 +173,17 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		add_test("order_by:parallel", () => test_order_by(true), prepare);
 		add_test("order_by:check-stable", () => test_stable_order_by(false), prepare);
 		add_test("order_by:check-stable:parallel", () => test_stable_order_by(true), prepare);
+		add_test("top_k", () => test_top_k(false), prepare);
+		add_test("top_k:parallel", () => test_top_k(true), prepare);
+		add_test("order_by:chop:check-stable", () => test_stable_order_by_chop(false), prepare);
+		add_test("order_by:chop:check-stable:parallel", () => test_stable_order_by_chop(true), prepare);
 
 		add_test("foreach", () => test_foreach(false), prepare);
 		add_test("foreach:parallel", () => test_foreach(true), prepare);
+		add_test("foreach:cancellation", () => test_foreach_cancellation(false), prepare);
+		add_test("foreach:cancellation:parallel", () => test_foreach_cancellation(true), prepare);
+		add_test("foreach:deadline", () => test_foreach_deadline(false), prepare);
+		add_test("foreach:deadline:parallel", () => test_foreach_deadline(true), prepare);
 
 		add_test("collect", () => test_collect(false), prepare);
 		add_test("collect:parallel", () => test_collect(true), prepare);
@@ -227,6 +241,10 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		add_test("collector-group_by:parallel", () => test_collector_group_by(true), prepare);
 		add_test("collector-group_by:ordered", () => test_collector_group_by(false, true), prepare);
 		add_test("collector-group_by:ordered:parallel", () => test_collector_group_by(true, true), prepare);
+		add_test("collector-sharded_group_by", () => test_collector_sharded_group_by(false), prepare);
+		add_test("collector-sharded_group_by:parallel", () => test_collector_sharded_group_by(true), prepare);
+		add_test("collector-sharded_group_by:ordered", () => test_collector_sharded_group_by(false, true), prepare);
+		add_test("collector-sharded_group_by:ordered:parallel", () => test_collector_sharded_group_by(true, true), prepare);
 		add_test("collector-partition", () => test_collector_partition(false), prepare);
 		add_test("collector-partition:parallel", () => test_collector_partition(true), prepare);
 		add_test("collector-partition:ordered", () => test_collector_partition(false, true), prepare);
@@ -240,6 +258,10 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		add_test("collector-min:parallel", () => test_collector_min(true), prepare);
 		add_test("collector-min:ordered", () => test_collector_min(false, true), prepare);
 		add_test("collector-min:ordered:parallel", () => test_collector_min(true, true), prepare);
+		add_test("collector-top_k", () => test_collector_top_k(false), prepare);
+		add_test("collector-top_k:parallel", () => test_collector_top_k(true), prepare);
+		add_test("collector-top_k:ordered", () => test_collector_top_k(false, true), prepare);
+		add_test("collector-top_k:ordered:parallel", () => test_collector_top_k(true, true), prepare);
 		add_test("collector-count", () => test_collector_count(false), prepare);
 		add_test("collector-count:parallel", () => test_collector_count(true), prepare);
 		add_test("collector-count:ordered", () => test_collector_count(false, true), prepare);
@@ -451,6 +473,64 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		assert_array_equals<G>(result_array.data, validation.data, equal);
 	}
 
+	private void test_sorted_distinct (bool parallel) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+
+		Iterator<G>[] iters = create_rand_iter(len).tee(2);
+		Seq<G> seq = Seq.of_iterator<G>(iters[0], len, true);
+		if (parallel) seq = seq.parallel();
+		// uses the default functions, so that distinct() can rely on the order
+		Iterator<G> result = seq.order_by().order_by().distinct().iterator();
+		GenericArray<G> result_array = iter_to_generic_array<G>(result);
+		assert_sorted<G>(result_array.data);
+
+		Set<G> result_set = new HashSet<G>();
+		for (int i = 0; i < result_array.length; i++) {
+			assert( result_set.add(result_array[i]) );
+		}
+		Set<G> validation = new HashSet<G>();
+		while (iters[1].next()) {
+			validation.add(iters[1].get());
+		}
+		assert(result_set.size == validation.size);
+		assert(result_set.contains_all(validation));
+	}
+
+	private void test_ordered_distinct (bool parallel) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+		GenericArray<G> distinct = iter_to_generic_array<G>(create_distinct_iter(len / 4));
+		int n = distinct.length;
+
+		// each element appears in every quarter, so duplicates are spread
+		// across the splits
+		GenericArray<G> input = new GenericArray<G>(n * 4);
+		for (int q = 0; q < 4; q++) {
+			for (int i = 0; i < n; i++) {
+				input.add(distinct[q % 2 == 0 ? i : n - 1 - i]);
+			}
+		}
+		Seq<G> seq = Seq.of_generic_array<G>(input);
+		if (parallel) seq = seq.parallel();
+		GenericArray<G> result = seq.distinct(hash, equal).to_generic_array().value;
+
+		assert(result.length == n);
+		Set<G> seen = new HashSet<G>(hash, equal);
+		for (int i = 0; i < n; i++) {
+			assert( seen.add(result[i]) );
+		}
+		if (parallel) {
+			// whichever occurrence is kept, the kept ones are in encounter order
+			int j = 0;
+			for (int i = 0; i < n; i++) {
+				while (j < input.length && !equal(input[j], result[i])) j++;
+				assert(j < input.length);
+				j++;
+			}
+		} else {
+			assert_array_equals<G>(result.data, distinct.data, equal);
+		}
+	}
+
 	private void test_all_match (bool parallel) {
 		Iterator<G>[] iters = create_rand_iter(__length).tee(3);
 
@@ -722,6 +802,24 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		assert( !result.has_next() );
 	}
 
+	private void test_filter_array_chunks (bool parallel) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+
+		GenericArray<G> array = iter_to_generic_array<G>(create_rand_iter(len), len);
+		Seq<G> seq = Seq.of_generic_array<G>(array);
+		if (parallel) seq = seq.parallel();
+		Gee.List<G> result = seq.filter((g) => filter(g))
+				.collect_ordered( Collectors.to_list<G>() ).value;
+
+		int idx = 0;
+		for (int i = 0; i < array.length; i++) {
+			if ( filter(array[i]) ) {
+				assert( equal(array[i], result[idx++]) );
+			}
+		}
+		assert(idx == result.size);
+	}
+
 	private void test_fold (bool parallel) {
 		Iterator<G>[] iters = create_rand_iter(__length).tee(2);
 		Seq<G> seq = Seq.of_iterator<G>(iters[0], __length, true);
@@ -914,6 +1012,69 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		assert_array_equals<Wrapper<G>>(array.data, result.data, (a, b) => a == b);
 	}
 
+	private void test_top_k (bool parallel) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+		int k = (int) int64.min(__limit, len);
+
+		GenericArray<G> array = iter_to_generic_array<G>(create_rand_iter(len), len);
+		Seq<G> seq = Seq.of_generic_array<G>(array);
+		if (parallel) seq = seq.parallel();
+		GenericArray<G> result = iter_to_generic_array<G>(
+			seq.top_k(__limit, compare).iterator(), k);
+
+		array.sort_with_data(compare);
+		assert_array_equals<G>(array.data[0:k], result.data, equal);
+	}
+
+	private void test_stable_order_by_chop (bool parallel) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+		int skip = (int) int64.min(__skip, len);
+		int k = (int) int64.min(__limit, len - skip);
+
+		var array = new GenericArray<Wrapper<G>>(len);
+		for (int i = 0; i < len; i++) {
+			array.add( new Wrapper<G>(random()) );
+		}
+
+		var seq = Seq.of_generic_array<Wrapper<G>>(array);
+		if (parallel) seq = seq.parallel();
+		var result_iter = seq.order_by((a, b) => compare(a.value, b.value))
+				.chop(__skip, __limit).iterator();
+		var result = iter_to_generic_array<Wrapper<G>>(result_iter, k);
+
+		array.sort_with_data((a, b) => compare(a.value, b.value));
+		assert_array_equals<Wrapper<G>>(array.data[skip:skip+k], result.data, (a, b) => a == b);
+	}
+
+	private void test_foreach_cancellation (bool parallel) {
+		var token = new CancellationToken();
+		Seq<G> seq = create_rand_seq().with_cancellation(token);
+		if (parallel) seq = seq.parallel();
+
+		int count = 0;
+		try {
+			seq.foreach(g => {
+				if (wrap_atomic_int_add(ref count, 1) == 1000) token.cancel();
+			}).wait();
+			assert_not_reached();
+		} catch (Error err) {
+			assert(err is CancellationError.CANCELLED);
+		}
+	}
+
+	private void test_foreach_deadline (bool parallel) {
+		int64 deadline = get_monotonic_time() + 10 * TimeSpan.MILLISECOND;
+		Seq<G> seq = create_rand_seq().with_deadline(deadline);
+		if (parallel) seq = seq.parallel();
+
+		try {
+			seq.foreach(g => {}).wait();
+			assert_not_reached();
+		} catch (Error err) {
+			assert(err is CancellationError.TIMED_OUT);
+		}
+	}
+
 	private void test_foreach (bool parallel) {
 		Iterator<G>[] iters = create_rand_iter(__length).tee(2);
 		Seq<G> seq = Seq.of_iterator<G>(iters[0], __length, true);
@@ -1243,6 +1404,35 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		});
 	}
 
+	private void test_collector_sharded_group_by (bool parallel, bool ordered = false) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+		Iterator<G>[] iters = create_rand_iter(len).tee(2);
+		Seq<G> seq = Seq.of_iterator<G>(iters[0], len, true);
+		if (parallel) seq = seq.parallel();
+
+		var collector = Collectors.sharded_group_by<int,G>(g => map_to_int(g) % 1000, -1, seq.task_env);
+		Map<int,Gee.List<G>> result;
+		if (ordered) {
+			result = seq.collect_ordered(collector).value;
+		} else {
+			result = seq.collect(collector).value;
+		}
+
+		var validation = new HashMap<int,Gee.List<G>>();
+		while (iters[1].next()) {
+			G val = iters[1].get();
+			int key = map_to_int(val) % 1000;
+			if ( !validation.has_key(key) ) {
+				validation[key] = new ArrayList<G>();
+			}
+			validation[key].add(val);
+		}
+		assert_map_equals<int,Gee.List<G>>(validation, result, (a, b) => {
+			assert_iter_equals<G>( ((Iterable<G>)a).iterator(), ((Iterable<G>)b).iterator(), equal );
+			return true;
+		});
+	}
+
 	private void test_collector_partition (bool parallel, bool ordered = false) {
 		int len = __length <= int.MAX ? (int)__length : int.MAX;
 		Iterator<G>[] iters = create_rand_iter(len).tee(2);
@@ -1330,6 +1520,29 @@ public abstract class SeqTests<G> : Gpseq.TestSuite {
 		assert( equal(result.value, validation) );
 	}
 
+	private void test_collector_top_k (bool parallel, bool ordered = false) {
+		int len = __length <= int.MAX ? (int)__length : int.MAX;
+		int k = (int) int64.min(__limit, len);
+
+		GenericArray<G> array = iter_to_generic_array<G>(create_rand_iter(len), len);
+		Seq<G> seq = Seq.of_generic_array<G>(array);
+		if (parallel) seq = seq.parallel();
+
+		var collector = Collectors.top_k<G>(__limit, compare);
+		Gee.List<G> result;
+		if (ordered) {
+			result = seq.collect_ordered(collector).value;
+		} else {
+			result = seq.collect(collector).value;
+		}
+
+		array.sort_with_data(compare);
+		assert(result.size == k);
+		for (int i = 0; i < k; i++) {
+			assert( equal(result[i], array[i]) );
+		}
+	}
+
 	private void test_collector_count (bool parallel, bool ordered = false) {
 		Seq<G> seq = Seq.of_iterator<G>(create_rand_iter(__length), __length, true);
 		if (parallel) seq = seq.parallel();
@@ -33,6 +33,8 @@ public class StringSeqTests : SeqTests<string> {
 	private void register_tests () {
 		add_test("collector-join", () => test_collector_join(false));
 		add_test("collector-join:parallel", () => test_collector_join(true));
+		add_test("of_file_lines", () => test_of_file_lines(false));
+		add_test("of_file_lines:parallel", () => test_of_file_lines(true));
 	}
 
 	protected override Seq<string> create_rand_seq () {
@@ -121,4 +123,38 @@ public class StringSeqTests : SeqTests<string> {
 			assert(seq.collect_ordered(Collectors.join(",")).value == ",d,on,,key,");
 		}
 	}
+
+	private void test_of_file_lines (bool parallel) {
+		const int LINES = 100000;
+		var builder = new StringBuilder();
+		var validation = new GenericArray<string>(LINES);
+		for (int i = 0; i < LINES; i++) {
+			string line = i % 7 == 0 ? "" : i.to_string();
+			validation.add(line);
+			builder.append(line);
+			builder.append(i % 5 == 0 ? "\r\n" : "\n");
+		}
+		validation.add("last");
+		builder.append("last"); // no trailing newline
+
+		string path;
+		try {
+			FileUtils.close( FileUtils.open_tmp("gpseq-XXXXXX", out path) );
+			FileUtils.set_contents(path, builder.str);
+			Seq<string> seq = Seq.of_file_lines(path);
+			if (parallel) seq = seq.parallel();
+			Gee.List<string> result = seq.collect_ordered( Collectors.to_list<string>() ).value;
+			// the size is estimated in records, not in bytes
+			int64 estimate = Seq.of_file_lines(path).spliterator().estimated_size;
+			assert(LINES / 2 < estimate < builder.len / 2);
+			FileUtils.remove(path);
+
+			assert(result.size == validation.length);
+			for (int i = 0; i < validation.length; i++) {
+				assert( str_equal(result[i], validation[i]) );
+			}
+		} catch (Error err) {
+			error("%s", err.message);
+		}
+	}
 }
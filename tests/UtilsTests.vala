@@ -38,8 +38,24 @@ public class UtilsTests : Gpseq.TestSuite {
 		add_test("parallel_sort<string?>:few", test_parallel_sort_nullable_strings_few);
 		add_test("parallel_sort<unowned string>:few", test_parallel_sort_unowned_strings_few);
 		add_test("parallel_sort:check-stable", test_parallel_sort_stable);
+		add_test("parallel_sort_in_place:check-stable", test_parallel_sort_in_place_stable);
+		add_test("parallel_sort_int64", test_parallel_sort_int64);
+		add_test("parallel_sort_double", test_parallel_sort_double);
+		add_test("parallel_sort_by_key:check-stable", test_parallel_sort_by_key_stable);
+		add_test("parallel_sort_strings", test_parallel_sort_strings);
+		add_test("parallel_for", test_parallel_for);
+		add_test("parallel_for:error", test_parallel_for_error);
 		add_test("task", test_task);
 		add_test("join", test_join);
+		add_test("worker-pool:topology", test_topology_worker_pool);
+		add_test("worker-pool:bursts", test_worker_pool_bursts);
+		add_test("worker-pool:concurrent-submissions", test_worker_pool_concurrent_submissions);
+		add_test("worker-pool:stats", test_worker_pool_stats);
+		add_test("worker-pool:lanes", test_worker_pool_lanes);
+		add_test("worker-pool:lanes:local-fork", test_worker_pool_lane_local_fork);
+		add_test("worker-pool:fan-out", test_worker_pool_fan_out);
+		add_test("task-trace", test_task_trace);
+		add_test("adaptive-task-env", test_adaptive_task_env);
 		add_test("overflow:int", test_overflow_int);
 		add_test("overflow:long", test_overflow_long);
 		add_test("overflow:int32", test_overflow_int32);
@@ -225,12 +241,219 @@ public class UtilsTests : Gpseq.TestSuite {
 		assert_array_equals<Wrapper<int>>(array.data, validation.data, (a, b) => a == b);
 	}
 
+	private void test_parallel_sort_in_place_stable () {
+		var array = new GenericArray<Wrapper<int>>(MANY_SORT_LENGTH * 4);
+		var validation = new GenericArray<Wrapper<int>>(MANY_SORT_LENGTH * 4);
+		for (int i = 0; i < MANY_SORT_LENGTH * 4; i++) {
+			var obj = new Wrapper<int>(Random.int_range(0, 1000));
+			array.add(obj);
+			validation.add(obj);
+		}
+		CompareDataFunc<Wrapper<int>> cmp = (a, b) => {
+			int v0 = a.value;
+			int v1 = b.value;
+			return v0 < v1 ? -1 : (v0 == v1 ? 0 : 1);
+		};
+		parallel_sort_in_place<Wrapper<int>>(array.data, (a, b) => cmp(a, b)).value;
+		validation.sort_with_data((a, b) => cmp(a, b));
+		assert_array_equals<Wrapper<int>>(array.data, validation.data, (a, b) => a == b);
+	}
+
+	private void test_parallel_sort_int64 () {
+		foreach (int length in new int[] {100, MANY_SORT_LENGTH * 4}) {
+			int64[] array = new int64[length];
+			uint64 sum = 0;
+			for (int i = 0; i < length; i++) {
+				array[i] = (int64) Random.next_int() - int32.MAX;
+				if (i % 3 == 0) array[i] *= 1000000007;
+				sum += (uint64) array[i];
+			}
+			parallel_sort_int64(array).value;
+			for (int i = 1; i < length; i++) {
+				assert(array[i-1] <= array[i]);
+			}
+			uint64 sorted_sum = 0;
+			foreach (int64 v in array) sorted_sum += (uint64) v;
+			assert(sum == sorted_sum);
+		}
+	}
+
+	private void test_parallel_sort_double () {
+		foreach (int length in new int[] {100, MANY_SORT_LENGTH * 4}) {
+			double[] array = new double[length];
+			for (int i = 0; i < length; i++) {
+				array[i] = Random.double_range(-1000, 1000);
+			}
+			array[0] = double.INFINITY;
+			array[1] = -double.INFINITY;
+			array[2] = 0;
+			parallel_sort_double(array).value;
+			assert(array[0] == -double.INFINITY);
+			assert(array[length-1] == double.INFINITY);
+			for (int i = 1; i < length; i++) {
+				assert(array[i-1] <= array[i]);
+			}
+		}
+	}
+
+	private void test_parallel_sort_by_key_stable () {
+		var array = new GenericArray<Wrapper<int>>(MANY_SORT_LENGTH * 4);
+		var validation = new GenericArray<Wrapper<int>>(MANY_SORT_LENGTH * 4);
+		for (int i = 0; i < MANY_SORT_LENGTH * 2; i++) {
+			var obj = new Wrapper<int>(0);
+			array.add(obj);
+			validation.add(obj);
+			obj = new Wrapper<int>(Random.int_range(-100, 100));
+			array.add(obj);
+			validation.add(obj);
+		}
+		parallel_sort_by_key<Wrapper<int>>(array.data, g => g.value).value;
+		validation.sort_with_data((a, b) => {
+			int v0 = a.value;
+			int v1 = b.value;
+			return v0 < v1 ? -1 : (v0 == v1 ? 0 : 1);
+		});
+		assert_array_equals<Wrapper<int>>(array.data, validation.data, (a, b) => a == b);
+	}
+
+	private void test_parallel_sort_strings () {
+		foreach (int length in new int[] {100, MANY_SORT_LENGTH * 4}) {
+			string[] array = new string[length];
+			var validation = new GenericArray<string>(length);
+			for (int i = 0; i < length; i++) {
+				// short alphabets and a shared prefix, to get equal bytes
+				var sb = new StringBuilder("prefix-");
+				int len = Random.int_range(0, 8);
+				for (int j = 0; j < len; j++) {
+					sb.append_c( (char) Random.int_range('a', 'e') );
+				}
+				array[i] = sb.str;
+				validation.add(sb.str);
+			}
+			parallel_sort_strings(array).value;
+			validation.sort(strcmp);
+			for (int i = 0; i < length; i++) {
+				assert(array[i] == validation[i]);
+			}
+		}
+	}
+
+	private void test_parallel_for () {
+		foreach (int grain in new int[] {0, 1, 100}) {
+			int[] array = new int[MANY_SORT_LENGTH];
+			parallel_for(0, array.length, i => { array[i] += i * 2; }, grain).value;
+			for (int i = 0; i < array.length; i++) {
+				assert(array[i] == i * 2);
+			}
+		}
+
+		int sum = 0;
+		parallel_for(-50, 50, i => { AtomicInt.add(ref sum, i); }).value;
+		assert(sum == -50);
+
+		int n = 0;
+		parallel_for(10, 10, i => { AtomicInt.inc(ref n); }).value;
+		parallel_for(10, 0, i => { AtomicInt.inc(ref n); }).value;
+		assert(n == 0);
+	}
+
+	private void test_parallel_for_error () {
+		var future = parallel_for(0, MANY_SORT_LENGTH, i => {
+			if (i == 1000) throw new OptionalError.NOT_PRESENT("i == 1000");
+		}, 64);
+		try {
+			future.wait();
+			assert_not_reached();
+		} catch (Error err) {
+			assert(err is OptionalError.NOT_PRESENT);
+		}
+	}
+
 	private void test_task () {
 		var future = Gpseq.task<int>(() => 726);
 		assert(future.value == 726);
 		assert(future.exception == null);
 	}
 
+	private void test_topology_worker_pool () {
+		var factory = new TopologyThreadFactory();
+		assert(factory.num_cpus > 0);
+		try {
+			var pool = new WorkerPool(4, factory);
+			var tasks = new GenericArray<FuncTask<int>>();
+			for (int i = 0; i < 100; i++) {
+				int n = i;
+				var t = new FuncTask<int>(() => n * 2);
+				pool.submit(t);
+				tasks.add(t);
+			}
+			for (int i = 0; i < tasks.length; i++) {
+				assert(tasks[i].future.wait() == i * 2);
+			}
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_worker_pool_bursts () {
+		try {
+			var pool = new WorkerPool(4, WorkerPool.get_default_factory());
+			for (int burst = 0; burst < 5; burst++) {
+				// let the threads park
+				Thread.usleep(20000);
+				var tasks = new GenericArray<FuncTask<int>>();
+				for (int i = 0; i < 50; i++) {
+					int n = i;
+					var t = new FuncTask<int>(() => n + burst);
+					pool.submit(t);
+					tasks.add(t);
+				}
+				for (int i = 0; i < tasks.length; i++) {
+					assert(tasks[i].future.wait() == i + burst);
+				}
+			}
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_worker_pool_concurrent_submissions () {
+		const int SUBMITTERS = 8;
+		const int TASKS = 1000; // > the capacity of a shard
+		try {
+			var pool = new WorkerPool(4, WorkerPool.get_default_factory());
+			int sum = 0;
+			var submitters = new Thread<void*>[SUBMITTERS];
+			for (int i = 0; i < SUBMITTERS; i++) {
+				submitters[i] = new Thread<void*>("submitter", () => {
+					var tasks = new GenericArray<FuncTask<int>>();
+					for (int j = 0; j < TASKS; j++) {
+						var t = new FuncTask<int>(() => 1);
+						pool.submit(t);
+						tasks.add(t);
+					}
+					try {
+						for (int j = 0; j < tasks.length; j++) {
+							AtomicInt.add(ref sum, tasks[j].future.wait());
+						}
+					} catch (Error err) {
+						error(err.message);
+					}
+					return null;
+				});
+			}
+			for (int i = 0; i < SUBMITTERS; i++) {
+				submitters[i].join();
+			}
+			assert(AtomicInt.get(ref sum) == SUBMITTERS * TASKS);
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
 	private void test_join () {
 		assert( fibonacci(10) == 55 );
 	}
@@ -248,6 +471,200 @@ public class UtilsTests : Gpseq.TestSuite {
 		}
 	}
 
+	private void test_worker_pool_stats () {
+		const int TASKS = 100;
+		try {
+			var pool = new WorkerPool(4, WorkerPool.get_default_factory());
+			assert(!pool.stats_enabled);
+			pool.stats_enabled = true;
+			var tasks = new GenericArray<FuncTask<int>>();
+			for (int i = 0; i < TASKS; i++) {
+				var t = new FuncTask<int>(() => 1);
+				pool.submit(t);
+				tasks.add(t);
+			}
+			for (int i = 0; i < tasks.length; i++) {
+				assert(tasks[i].future.wait() == 1);
+			}
+
+			// the counters are updated after the tasks are completed
+			int64 end = get_monotonic_time() + 5 * SECONDS;
+			while (pool.get_stats().tasks_executed < TASKS && get_monotonic_time() < end) {
+				Thread.usleep(1000);
+			}
+			WorkerStats stats = pool.get_stats();
+			assert(stats.tasks_executed == TASKS);
+			assert(stats.drained_tasks == TASKS);
+			assert(stats.mean_task_time >= 0);
+
+			Gee.List<WorkerStats> workers = pool.get_worker_stats();
+			assert(workers.size == 4);
+			int64 executed = 0;
+			foreach (WorkerStats w in workers) executed += w.tasks_executed;
+			assert(executed == TASKS);
+
+			pool.reset_stats();
+			stats = pool.get_stats();
+			assert(stats.tasks_executed == 0);
+			assert(stats.drained_tasks == 0);
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_worker_pool_fan_out () {
+		// a deep task tree of single-index leaves; most tasks are stolen
+		// in batches during the initial fan-out
+		int length = 200000;
+		int[] counts = new int[length];
+		int total = 0;
+		parallel_for(0, length, i => {
+			counts[i]++;
+			AtomicInt.inc(ref total);
+		}, 1).value;
+		assert(AtomicInt.get(ref total) == length);
+		for (int i = 0; i < length; i++) {
+			assert(counts[i] == 1);
+		}
+	}
+
+	private void test_worker_pool_lanes () {
+		const int TASKS = 10;
+		try {
+			var pool = new WorkerPool(1, WorkerPool.get_default_factory());
+			WorkerPoolLane high = pool.create_lane("high", TaskPriority.HIGH);
+			WorkerPoolLane low = pool.create_lane("low", TaskPriority.LOW);
+			assert(high.name == "high" && high.priority == TaskPriority.HIGH);
+			assert(low.parallels == pool.parallels);
+
+			// occupy the only thread while the tasks are submitted
+			int started = 0;
+			int released = 0;
+			var blocker = new FuncTask<int>(() => {
+				AtomicInt.set(ref started, 1);
+				while (AtomicInt.get(ref released) == 0) Thread.usleep(1000);
+				return 0;
+			});
+			pool.submit(blocker);
+			while (AtomicInt.get(ref started) == 0) Thread.usleep(1000);
+
+			int seq = 0;
+			var low_tasks = new GenericArray<FuncTask<int>>();
+			var high_tasks = new GenericArray<FuncTask<int>>();
+			for (int i = 0; i < TASKS; i++) {
+				var t = new FuncTask<int>(() => AtomicInt.add(ref seq, 1));
+				low.submit(t);
+				low_tasks.add(t);
+			}
+			for (int i = 0; i < TASKS; i++) {
+				var t = new FuncTask<int>(() => AtomicInt.add(ref seq, 1));
+				high.submit(t);
+				high_tasks.add(t);
+			}
+			AtomicInt.set(ref released, 1);
+
+			int last_high = -1;
+			for (int i = 0; i < TASKS; i++) {
+				last_high = int.max(last_high, high_tasks[i].future.wait());
+			}
+			for (int i = 0; i < TASKS; i++) {
+				assert(low_tasks[i].future.wait() > last_high);
+			}
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_worker_pool_lane_local_fork () {
+		try {
+			var pool = new WorkerPool(1, WorkerPool.get_default_factory());
+			WorkerPoolLane low = pool.create_lane("low", TaskPriority.LOW);
+
+			// a task submitted through the lane in a worker thread, like a
+			// forked subtask, goes to the work queue of the thread
+			int64 queued = -1;
+			var child = new FuncTask<int>(() => 1);
+			var parent = new FuncTask<int>(() => {
+				low.submit(child);
+				queued = pool.get_worker_stats()[0].queued_tasks;
+				return 0;
+			});
+			low.submit(parent);
+			parent.future.wait();
+			assert(child.future.wait() == 1);
+			assert(queued == 1);
+
+			// and so do the subtasks of a parallel seq on the lane: while a
+			// leaf runs, its forked siblings wait in the work queue
+			int[] array = new int[16384];
+			for (int i = 0; i < array.length; i++) array[i] = i;
+			int64 max_queued = 0;
+			Seq.of_array<int>(array, new FixedTaskEnv(low, 1024)).parallel().foreach(g => {
+				if (g % 1024 == 0) {
+					// only one worker thread
+					max_queued = int64.max(max_queued, pool.get_worker_stats()[0].queued_tasks);
+				}
+			}).wait();
+			assert(max_queued > 0);
+			pool.terminate_now();
+		} catch (Error err) {
+			error(err.message);
+		}
+	}
+
+	private void test_task_trace () {
+		const int LENGTH = 100000;
+		int[] array = new int[LENGTH];
+		for (int i = 0; i < LENGTH; i++) array[i] = 1;
+
+		int forks = 0;
+		int joins = 0;
+		set_task_trace_func((event, task) => {
+			if (event == TaskTraceEvent.FORK) {
+				AtomicInt.inc(ref forks);
+			} else if (event == TaskTraceEvent.JOIN_END) {
+				AtomicInt.inc(ref joins);
+			}
+		});
+		int sum = Seq.of_array<int>(array, TestTaskEnv.get_instance()).parallel()
+			.fold<int>((g, a) => g + a, (a, b) => a + b, 0).value;
+		set_task_trace_func(null);
+
+		assert(sum == LENGTH);
+		assert(AtomicInt.get(ref forks) > 0);
+		assert(AtomicInt.get(ref joins) >= AtomicInt.get(ref forks));
+	}
+
+	private void test_adaptive_task_env () {
+		const int LENGTH = 100000;
+		int[] array = new int[LENGTH];
+		for (int i = 0; i < LENGTH; i++) array[i] = i % 100;
+		int expected = LENGTH / 100 * 4950;
+
+		var env = new AdaptiveTaskEnv();
+		assert(env.element_cost < 0);
+		for (int i = 0; i < 4; i++) {
+			int sum = Seq.of_array<int>(array, env).parallel()
+				.fold<int>((g, a) => g + a, (a, b) => a + b, 0).value;
+			assert(sum == expected);
+		}
+		assert(env.element_cost > 0);
+
+		int threads = env.executor.parallels;
+		if (threads > 1) {
+			int64 threshold = env.resolve_threshold(LENGTH, threads);
+			// either not split at all, or split into at least two leaves per thread
+			assert(threshold == LENGTH || 1 <= threshold <= LENGTH / (threads * 2));
+			assert(env.resolve_max_depth(LENGTH, threads) < 0);
+		}
+		assert(env.resolve_threshold(LENGTH, 1) == LENGTH);
+
+		env.reset();
+		assert(env.element_cost < 0);
+	}
+
 	private void test_overflow_int () {
 		int val;
 		assert( !int_add(1, 2, out val) );
@@ -450,3 +867,31 @@ public class UtilsTests : Gpseq.TestSuite {
 		}
 	}
 }
+
+/**
+ * A task env which splits inputs down to a fixed threshold, even with one
+ * thread.
+ */
+private class FixedTaskEnv : TaskEnv {
+	private Executor _executor;
+	private int64 _threshold;
+
+	public FixedTaskEnv (Executor executor, int64 threshold) {
+		_executor = executor;
+		_threshold = threshold;
+	}
+
+	public override Executor executor {
+		get {
+			return _executor;
+		}
+	}
+
+	public override int64 resolve_threshold (int64 elements, int threads) {
+		return _threshold;
+	}
+
+	public override int resolve_max_depth (int64 elements, int threads) {
+		return -1;
+	}
+}
@@ -0,0 +1,85 @@
+/* WorkQueueTests.vala
+ *
+ * Copyright (C) 2019-2020  Космическое П. (kosmospredanie@yandex.ru)
+ *
+ * This file is part of Gpseq.
+ *
+ * Gpseq is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * Gpseq is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Gpseq.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+using Gpseq;
+
+/**
+ * Tests of the internal work queue, through the internal vapi of the
+ * library.
+ */
+public class WorkQueueTests : Gpseq.TestSuite {
+	private const int LOG_CAPACITY = 4;
+	private const int CAPACITY = (1 << LOG_CAPACITY) - 1;
+
+	public WorkQueueTests () {
+		base("work-queue");
+		add_test("offer-tail:full", test_offer_tail_full);
+		add_test("steal-to:full", test_steal_to_full);
+	}
+
+	private Task create_task () {
+		return new FuncTask<void*>(() => null);
+	}
+
+	private WorkQueue create_full_queue () {
+		var queue = new WorkQueue.with_max_log_capacity(LOG_CAPACITY);
+		for (int i = 0; i < CAPACITY; i++) {
+			assert( queue.offer_tail(create_task()) );
+		}
+		return queue;
+	}
+
+	private void test_offer_tail_full () {
+		WorkQueue queue = create_full_queue();
+		assert(queue.size == CAPACITY);
+		assert(queue.remaining_capacity == 0);
+		assert( !queue.offer_tail(create_task()) );
+		assert(queue.size == CAPACITY);
+
+		assert(queue.poll_tail() != null);
+		assert(queue.remaining_capacity == 1);
+		assert( queue.offer_tail(create_task()) );
+		assert( !queue.offer_tail(create_task()) );
+	}
+
+	private void test_steal_to_full () {
+		const int ROOM = 5;
+		WorkQueue src = create_full_queue();
+		var dest = new WorkQueue.with_max_log_capacity(LOG_CAPACITY);
+		for (int i = 0; i < CAPACITY - ROOM; i++) {
+			assert( dest.offer_tail(create_task()) );
+		}
+
+		// capped by the remaining capacity of the destination
+		assert(src.steal_to(dest, CAPACITY) == ROOM);
+		assert(dest.size == CAPACITY);
+		assert(dest.remaining_capacity == 0);
+		assert(src.size == CAPACITY - ROOM);
+
+		assert(src.steal_to(dest, CAPACITY) == 0);
+		assert(src.size == CAPACITY - ROOM);
+		assert( !dest.offer_tail(create_task()) );
+
+		while (dest.poll_tail() != null);
+		assert(dest.is_empty);
+		assert(src.steal_to(dest, CAPACITY) == CAPACITY - ROOM);
+		assert(src.is_empty);
+	}
+}
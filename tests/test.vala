@@ -35,6 +35,7 @@ void register_tests () {
 	new ResultTests().register();
 	new FutureTests().register();
 	new SubArrayTests().register();
+	new NumericSeqTests().register();
 	new UtilsTests().register();
 	new IntSeqTests().register();
 	new NullableIntSeqTests().register();